@@ -0,0 +1,44 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+#include "s0_benchmark.hpp"
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 and (std::string_view(argv[1]) == "--help" or std::string_view(argv[1]) == "-h"))
+    {
+        std::cout << s0m4b0dY::benchmark::Options::usage();
+        return 0;
+    }
+
+    s0m4b0dY::benchmark::Options options;
+    try
+    {
+        options = s0m4b0dY::benchmark::Options::parse(argc, argv);
+    }
+    catch (const std::invalid_argument &error)
+    {
+        std::cerr << error.what() << '\n' << s0m4b0dY::benchmark::Options::usage();
+        return 2;
+    }
+
+    s0m4b0dY::benchmark::Suite suite(options);
+    s0m4b0dY::benchmark::runThreadPoolBenchmarks(suite);
+    s0m4b0dY::benchmark::runAlgorithmBenchmarks(suite);
+
+    if (options.output.empty())
+        suite.writeJson(std::cout);
+    else
+    {
+        std::ofstream file(options.output);
+        suite.writeJson(file);
+        if (not file)
+        {
+            std::cerr << "Could not write " << options.output << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
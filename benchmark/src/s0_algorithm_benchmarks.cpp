@@ -0,0 +1,201 @@
+#include "s0_benchmark.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "s0_parallel_algorithms_threading.hpp"
+
+namespace
+{
+    using s0m4b0dY::benchmark::Case;
+    using s0m4b0dY::benchmark::Distribution;
+    using s0m4b0dY::benchmark::Suite;
+    using s0m4b0dY::benchmark::toString;
+
+    // Keeps the optimizer from dropping a result nobody reads.
+    template <class T>
+    void keep(const T &value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /**
+     * @brief Tasks, steals and the busiest worker's share of the busy time between two snapshots of a pool,
+     * to spot passes that leave workers idle. Empty unless the pool is built with S0_THREAD_POOL_METRICS.
+     */
+    std::vector<std::pair<std::string, double>> workerBalance(const s0m4b0dY::ThreadPool::Metrics &before,
+                                                              const s0m4b0dY::ThreadPool::Metrics &after)
+    {
+        if constexpr (not s0m4b0dY::ThreadPool::metricsEnabled)
+            return {};
+        double tasks = 0, steals = 0, busy = 0, busiest = 0;
+        for (std::size_t i = 0; i < after.workers.size(); ++i)
+        {
+            auto previous = i < before.workers.size() ? before.workers[i] : s0m4b0dY::ThreadPool::WorkerMetrics();
+            auto workerBusy = std::chrono::duration<double>(after.workers[i].busyTime - previous.busyTime).count();
+            tasks += static_cast<double>(after.workers[i].tasksExecuted - previous.tasksExecuted);
+            steals += static_cast<double>(after.workers[i].steals - previous.steals);
+            busy += workerBusy;
+            busiest = std::max(busiest, workerBusy);
+        }
+        return {{"worker_tasks", tasks}, {"worker_steals", steals}, {"busiest_worker_share", busy > 0 ? busiest / busy : 0.0}};
+    }
+
+    struct Pools
+    {
+        explicit Pools(const std::vector<std::size_t> &threads)
+        {
+            for (auto count : threads)
+                pools.push_back(std::make_unique<s0m4b0dY::ThreadPool>(static_cast<int>(count)));
+        }
+
+        std::vector<std::unique_ptr<s0m4b0dY::ThreadPool>> pools;
+    };
+
+    /**
+     * @brief Runs @p name sequentially, with std::execution::par and with Threading on every pool.
+     * @p run gets the execution policy or the Threading to use.
+     */
+    template <class Setup, class Run>
+    void compare(Suite &suite, Pools &pools, Case benchmarkCase, Setup &&setup, Run &&run)
+    {
+        if (not suite.selected(benchmarkCase.name))
+            return;
+        benchmarkCase.implementation = "std::seq";
+        benchmarkCase.threads = 1;
+        suite.measure(benchmarkCase, setup, [&run]() { run(std::execution::seq); });
+        benchmarkCase.implementation = "std::par";
+        benchmarkCase.threads = 0;
+        suite.measure(benchmarkCase, setup, [&run]() { run(std::execution::par); });
+        benchmarkCase.implementation = "s0";
+        for (auto &pool : pools.pools)
+        {
+            s0m4b0dY::Threading threading(*pool);
+            benchmarkCase.threads = pool->size();
+            benchmarkCase.scheduling = toString(pool->scheduling());
+            auto before = pool->metrics();
+            suite.measure(benchmarkCase, setup, [&run, &threading]() { run(threading); });
+            suite.annotate(workerBalance(before, pool->metrics()));
+        }
+    }
+
+    template <class T>
+    void runLinear(Suite &suite, Pools &pools, const std::string &type, Distribution distribution, std::size_t size)
+    {
+        if (not suite.selected("reduce") and not suite.selected("find_if") and not suite.selected("count_if") and not suite.selected("transform"))
+            return;
+        auto data = s0m4b0dY::benchmark::makeData<T>(size, distribution);
+        std::vector<T> output(size);
+        Case benchmarkCase{"", "", type, std::string(toString(distribution)), size, 0, ""};
+        auto noSetup = []() {};
+
+        benchmarkCase.name = "reduce";
+        compare(suite, pools, benchmarkCase, noSetup, [&data](auto &&executor)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(executor)>, s0m4b0dY::Threading>)
+                    keep(executor.reduce(data.begin(), data.end()));
+                else
+                    keep(std::reduce(executor, data.begin(), data.end()));
+            });
+
+        // The first match lies near the front of uniform data, at the front of reversed data,
+        // in the last percent of sorted data and nowhere in few unique data, which scans everything.
+        benchmarkCase.name = "find_if";
+        auto topPercent = [](T value) { return value >= T(990); };
+        compare(suite, pools, benchmarkCase, noSetup, [&data, &topPercent](auto &&executor)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(executor)>, s0m4b0dY::Threading>)
+                    keep(executor.find_if(data.begin(), data.end(), topPercent));
+                else
+                    keep(std::find_if(executor, data.begin(), data.end(), topPercent));
+            });
+
+        benchmarkCase.name = "count_if";
+        auto lowHalf = [](T value) { return value < T(500); };
+        compare(suite, pools, benchmarkCase, noSetup, [&data, &lowHalf](auto &&executor)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(executor)>, s0m4b0dY::Threading>)
+                    keep(executor.count_if(data.begin(), data.end(), lowHalf));
+                else
+                    keep(std::count_if(executor, data.begin(), data.end(), lowHalf));
+            });
+
+        benchmarkCase.name = "transform";
+        auto affine = [](T value) { return static_cast<T>(value * T(3) + T(1)); };
+        compare(suite, pools, benchmarkCase, noSetup, [&data, &output, &affine](auto &&executor)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(executor)>, s0m4b0dY::Threading>)
+                    executor.transform(data.begin(), data.end(), output.begin(), affine);
+                else
+                    std::transform(executor, data.begin(), data.end(), output.begin(), affine);
+                keep(output.back());
+            });
+    }
+
+    /**
+     * @brief Sorts a fresh copy of the input every repetition, the copy is not timed.
+     * The baselines are std::sort, as neither bitonic, odd-even nor radix sort exists in the STL.
+     */
+    template <class T>
+    void runSort(Suite &suite, Pools &pools, const std::string &name, const std::string &type,
+                 Distribution distribution, std::size_t size)
+    {
+        if (not suite.selected(name))
+            return;
+        auto data = s0m4b0dY::benchmark::makeData<T>(size, distribution);
+        std::vector<T> work(size);
+        Case benchmarkCase{name, "", type, std::string(toString(distribution)), size, 0, ""};
+        compare(suite, pools, benchmarkCase, [&data, &work]() { std::copy(data.begin(), data.end(), work.begin()); },
+            [&work, &name](auto &&executor)
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(executor)>, s0m4b0dY::Threading>)
+                {
+                    if (name == "bitonic_sort")
+                        executor.bitonic_sort(work.begin(), work.end());
+                    else if (name == "radix_sort")
+                        executor.radix_sort(work.begin(), work.end());
+                    else
+                        executor.odd_even_sort(work.begin(), work.end());
+                }
+                else
+                    std::sort(executor, work.begin(), work.end());
+                keep(work.front());
+            });
+    }
+
+    template <class T>
+    void runType(Suite &suite, Pools &pools, const std::string &type)
+    {
+        const auto &options = suite.options();
+        for (auto distribution : options.distributions)
+        {
+            for (auto size : options.sizes(options.maxSize))
+                runLinear<T>(suite, pools, type, distribution, size);
+            // bitonic_sort only takes powers of two.
+            for (auto size : options.sizes(options.maxSize))
+                runSort<T>(suite, pools, "bitonic_sort", type, distribution, std::bit_floor(size));
+            for (auto size : options.sizes(options.maxSize))
+                runSort<T>(suite, pools, "radix_sort", type, distribution, size);
+            for (auto size : options.sizes(options.quadraticMaxSize))
+                runSort<T>(suite, pools, "odd_even_sort", type, distribution, size);
+        }
+    }
+}
+
+void s0m4b0dY::benchmark::runAlgorithmBenchmarks(Suite &suite)
+{
+    Pools pools(suite.options().threads);
+    if (suite.options().hasType("uint32"))
+        runType<std::uint32_t>(suite, pools, "uint32");
+    if (suite.options().hasType("int64"))
+        runType<std::int64_t>(suite, pools, "int64");
+    if (suite.options().hasType("double"))
+        runType<double>(suite, pools, "double");
+}
@@ -0,0 +1,248 @@
+#include "s0_benchmark.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    std::vector<std::string_view> split(std::string_view list)
+    {
+        std::vector<std::string_view> items;
+        while (not list.empty())
+        {
+            auto comma = list.find(',');
+            items.push_back(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        }
+        return items;
+    }
+
+    // Accepts 1000, 1e9, 0.5 and 1'000'000 style numbers.
+    double parseNumber(std::string_view text)
+    {
+        std::string digits;
+        std::copy_if(text.begin(), text.end(), std::back_inserter(digits), [](char c) { return c != '\''; });
+        double value = 0;
+        auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (error != std::errc() or end != digits.data() + digits.size() or value < 0)
+            throw std::invalid_argument("Malformed number: " + std::string(text));
+        return value;
+    }
+
+    std::size_t parseSize(std::string_view text)
+    {
+        return static_cast<std::size_t>(parseNumber(text));
+    }
+
+    s0m4b0dY::benchmark::Distribution parseDistribution(std::string_view text)
+    {
+        using s0m4b0dY::benchmark::Distribution;
+        for (auto distribution : {Distribution::Uniform, Distribution::Sorted, Distribution::Reversed, Distribution::FewUnique})
+            if (toString(distribution) == text)
+                return distribution;
+        throw std::invalid_argument("Unknown distribution: " + std::string(text));
+    }
+
+    double percentile(std::vector<double> samples, double fraction)
+    {
+        auto index = static_cast<std::size_t>(fraction * (samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    void writeString(std::ostream &stream, std::string_view text)
+    {
+        stream << '"';
+        for (char c : text)
+        {
+            if (c == '"' or c == '\\')
+                stream << '\\';
+            stream << c;
+        }
+        stream << '"';
+    }
+}
+
+std::string_view s0m4b0dY::benchmark::toString(ThreadPool::Scheduling scheduling)
+{
+    return scheduling == ThreadPool::Scheduling::SharedQueue ? "shared_queue" : "work_stealing";
+}
+
+std::string_view s0m4b0dY::benchmark::toString(Distribution distribution)
+{
+    switch (distribution)
+    {
+    case Distribution::Uniform:
+        return "uniform";
+    case Distribution::Sorted:
+        return "sorted";
+    case Distribution::Reversed:
+        return "reversed";
+    case Distribution::FewUnique:
+        return "few_unique";
+    }
+    return "unknown";
+}
+
+std::string_view s0m4b0dY::benchmark::Options::usage()
+{
+    return "Usage: s0m4b0dY_parallel_algorithms_benchmark [options]\n"
+           "  --min-size N            smallest input size (default 1e3)\n"
+           "  --max-size N            largest input size, sizes grow tenfold (default 1e7, up to 1e9)\n"
+           "  --quadratic-max-size N  largest odd_even_sort input (default 16384)\n"
+           "  --max-tasks N           largest ThreadPool task count (default 1e6)\n"
+           "  --threads 1,2,4         ThreadPool sizes (default powers of two up to hardware_concurrency)\n"
+           "  --types uint32,int64,double\n"
+           "  --distributions uniform,sorted,reversed,few_unique\n"
+           "  --repetitions N         timed runs per case (default 5)\n"
+           "  --time-budget SECONDS   stop repeating a case after this long (default 2)\n"
+           "  --filter TEXT           only benchmarks whose name contains TEXT\n"
+           "  --output FILE           JSON results (default stdout)\n";
+}
+
+s0m4b0dY::benchmark::Options s0m4b0dY::benchmark::Options::parse(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view flag = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("Missing value for " + std::string(flag));
+        std::string_view value = argv[++i];
+        if (flag == "--min-size")
+            options.minSize = std::max<std::size_t>(1, parseSize(value));
+        else if (flag == "--max-size")
+            options.maxSize = parseSize(value);
+        else if (flag == "--quadratic-max-size")
+            options.quadraticMaxSize = parseSize(value);
+        else if (flag == "--max-tasks")
+            options.maxTasks = parseSize(value);
+        else if (flag == "--threads")
+        {
+            options.threads.clear();
+            for (auto item : split(value))
+                options.threads.push_back(std::max<std::size_t>(1, parseSize(item)));
+        }
+        else if (flag == "--types")
+        {
+            options.types.clear();
+            for (auto item : split(value))
+            {
+                if (item != "uint32" and item != "int64" and item != "double")
+                    throw std::invalid_argument("Unknown type: " + std::string(item));
+                options.types.emplace_back(item);
+            }
+        }
+        else if (flag == "--distributions")
+        {
+            options.distributions.clear();
+            for (auto item : split(value))
+                options.distributions.push_back(parseDistribution(item));
+        }
+        else if (flag == "--repetitions")
+            options.repetitions = std::max<std::size_t>(1, parseSize(value));
+        else if (flag == "--time-budget")
+            options.timeBudget = std::chrono::duration<double>(parseNumber(value));
+        else if (flag == "--filter")
+            options.filter = value;
+        else if (flag == "--output")
+            options.output = value;
+        else
+            throw std::invalid_argument("Unknown option: " + std::string(flag));
+    }
+    if (options.threads.empty())
+    {
+        auto hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t threads = 1; threads < hardware; threads *= 2)
+            options.threads.push_back(threads);
+        options.threads.push_back(hardware);
+    }
+    return options;
+}
+
+std::vector<std::size_t> s0m4b0dY::benchmark::Options::sizes(std::size_t limit) const
+{
+    std::vector<std::size_t> sizes;
+    for (auto size = minSize; size <= std::min(limit, maxSize); size *= 10)
+        sizes.push_back(size);
+    return sizes;
+}
+
+bool s0m4b0dY::benchmark::Options::hasType(std::string_view type) const
+{
+    return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+s0m4b0dY::benchmark::Suite::Suite(Options options)
+    : options_(std::move(options))
+{ }
+
+const s0m4b0dY::benchmark::Options &s0m4b0dY::benchmark::Suite::options() const noexcept
+{
+    return options_;
+}
+
+bool s0m4b0dY::benchmark::Suite::selected(std::string_view name) const
+{
+    return name.find(options_.filter) != std::string_view::npos;
+}
+
+void s0m4b0dY::benchmark::Suite::record(Result result)
+{
+    const auto &benchmarkCase = result.benchmarkCase;
+    std::clog << benchmarkCase.name << ' ' << benchmarkCase.implementation << ' ' << benchmarkCase.type << ' '
+              << benchmarkCase.distribution << " n=" << benchmarkCase.size << " threads=" << benchmarkCase.threads
+              << (benchmarkCase.scheduling.empty() ? "" : " ") << benchmarkCase.scheduling << ": " << std::fixed << std::setprecision(3) << percentile(result.samplesNs, 0.5) / 1e6 << " ms" << std::endl;
+    results_.push_back(std::move(result));
+}
+
+void s0m4b0dY::benchmark::Suite::annotate(std::vector<std::pair<std::string, double>> extra)
+{
+    if (results_.empty())
+        return;
+    auto &target = results_.back().extra;
+    target.insert(target.end(), std::make_move_iterator(extra.begin()), std::make_move_iterator(extra.end()));
+}
+
+void s0m4b0dY::benchmark::Suite::writeJson(std::ostream &stream) const
+{
+    stream << std::setprecision(17) << "{\n  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [";
+    for (std::size_t i = 0; i < results_.size(); ++i)
+    {
+        const auto &result = results_[i];
+        const auto &benchmarkCase = result.benchmarkCase;
+        const auto &samples = result.samplesNs;
+        auto median = percentile(samples, 0.5);
+        stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeString(stream, benchmarkCase.name);
+        stream << ", \"implementation\": ";
+        writeString(stream, benchmarkCase.implementation);
+        stream << ", \"type\": ";
+        writeString(stream, benchmarkCase.type);
+        stream << ", \"distribution\": ";
+        writeString(stream, benchmarkCase.distribution);
+        stream << ", \"size\": " << benchmarkCase.size
+               << ", \"threads\": " << benchmarkCase.threads
+               << ", \"scheduling\": ";
+        writeString(stream, benchmarkCase.scheduling);
+        stream << ", \"repetitions\": " << samples.size()
+               << ", \"min_ns\": " << *std::min_element(samples.begin(), samples.end())
+               << ", \"median_ns\": " << median
+               << ", \"mean_ns\": " << std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size()
+               << ", \"max_ns\": " << *std::max_element(samples.begin(), samples.end())
+               << ", \"items_per_second\": " << (median > 0 ? benchmarkCase.size * 1e9 / median : 0.0);
+        for (const auto &[key, value] : result.extra)
+        {
+            stream << ", ";
+            writeString(stream, key);
+            stream << ": " << value;
+        }
+        stream << '}';
+    }
+    stream << "\n  ]\n}\n";
+}
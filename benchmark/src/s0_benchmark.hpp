@@ -0,0 +1,204 @@
+#ifndef S0_BENCHMARK_HPP
+#define S0_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s0_thread_pool.hpp"
+
+namespace s0m4b0dY::benchmark
+{
+    enum class Distribution
+    {
+        Uniform,
+        Sorted,
+        Reversed,
+        FewUnique
+    };
+
+    std::string_view toString(Distribution distribution);
+    std::string_view toString(ThreadPool::Scheduling scheduling);
+
+    struct Options
+    {
+        std::size_t minSize = 1'000;
+        std::size_t maxSize = 10'000'000;
+        /**
+         * @brief Upper bound for the O(n^2) odd_even_sort, which would not finish at the other sizes.
+         */
+        std::size_t quadraticMaxSize = 1 << 14;
+        /**
+         * @brief Upper bound for the ThreadPool task counts.
+         */
+        std::size_t maxTasks = 1'000'000;
+        std::vector<std::size_t> threads;
+        std::vector<std::string> types = {"uint32", "int64", "double"};
+        std::vector<Distribution> distributions = {Distribution::Uniform, Distribution::Sorted, Distribution::Reversed, Distribution::FewUnique};
+        std::size_t repetitions = 5;
+        /**
+         * @brief Stop repeating a case once it took this long, so the large sizes run only once.
+         */
+        std::chrono::duration<double> timeBudget = std::chrono::seconds(2);
+        std::string filter;
+        std::filesystem::path output;
+
+        /**
+         * @brief Parses the command line, see usage().
+         * @throws std::invalid_argument on unknown flags or malformed values.
+         */
+        static Options parse(int argc, char **argv);
+        static std::string_view usage();
+
+        /**
+         * @brief minSize, 10 * minSize, ... up to @p limit (and maxSize).
+         */
+        std::vector<std::size_t> sizes(std::size_t limit) const;
+        bool hasType(std::string_view type) const;
+    };
+
+    struct Case
+    {
+        std::string name;
+        /**
+         * @brief "s0", "std::seq" or "std::par".
+         */
+        std::string implementation;
+        std::string type;
+        std::string distribution;
+        std::size_t size = 0;
+        /**
+         * @brief Worker count of the ThreadPool, 0 where the implementation picks it itself.
+         */
+        std::size_t threads = 0;
+        /**
+         * @brief ThreadPool::Scheduling of the pool, empty where no ThreadPool runs the case.
+         */
+        std::string scheduling;
+    };
+
+    struct Result
+    {
+        Case benchmarkCase;
+        std::vector<double> samplesNs;
+        std::vector<std::pair<std::string, double>> extra;
+    };
+
+    /**
+     * @brief Collects the timings of every case and writes them as JSON.
+     */
+    class Suite
+    {
+    public:
+        explicit Suite(Options options);
+
+        const Options &options() const noexcept;
+
+        /**
+         * @brief Whether @p name matches the --filter substring.
+         */
+        bool selected(std::string_view name) const;
+
+        /**
+         * @brief Calls @p setup and times @p run until repetitions or the time budget are exhausted.
+         * One untimed warm-up run comes first unless it alone exceeds the budget, then it is the only sample.
+         */
+        template <class Setup, class Run>
+        void measure(Case benchmarkCase, Setup &&setup, Run &&run);
+
+        template <class Run>
+        void measure(Case benchmarkCase, Run &&run);
+
+        void record(Result result);
+
+        /**
+         * @brief Appends @p extra to the result recorded last.
+         */
+        void annotate(std::vector<std::pair<std::string, double>> extra);
+
+        void writeJson(std::ostream &stream) const;
+
+    private:
+        Options options_;
+        std::vector<Result> results_;
+    };
+
+    /**
+     * @brief Deterministic input data, the same for every implementation of a case.
+     */
+    template <class T>
+    std::vector<T> makeData(std::size_t size, Distribution distribution);
+
+    void runAlgorithmBenchmarks(Suite &suite);
+    void runThreadPoolBenchmarks(Suite &suite);
+
+    template <class Setup, class Run>
+    inline void Suite::measure(Case benchmarkCase, Setup &&setup, Run &&run)
+    {
+        using Clock_t = std::chrono::steady_clock;
+        auto timed = [&]()
+        {
+            setup();
+            auto start = Clock_t::now();
+            run();
+            return std::chrono::duration<double, std::nano>(Clock_t::now() - start);
+        };
+
+        Result result{std::move(benchmarkCase), {}, {}};
+        auto warmUp = timed();
+        if (warmUp > options_.timeBudget)
+            result.samplesNs.push_back(warmUp.count());
+        else
+        {
+            std::chrono::duration<double, std::nano> elapsed{};
+            for (std::size_t repetition = 0; repetition < options_.repetitions and elapsed < options_.timeBudget; ++repetition)
+            {
+                auto sample = timed();
+                elapsed += sample;
+                result.samplesNs.push_back(sample.count());
+            }
+        }
+        record(std::move(result));
+    }
+
+    template <class Run>
+    inline void Suite::measure(Case benchmarkCase, Run &&run)
+    {
+        measure(std::move(benchmarkCase), []() {}, std::forward<Run>(run));
+    }
+
+    template <class T>
+    inline std::vector<T> makeData(std::size_t size, Distribution distribution)
+    {
+        std::vector<T> data(size);
+        std::mt19937_64 engine(size);
+        auto draw = [&engine](std::uint64_t bound) -> T
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return static_cast<T>(std::uniform_real_distribution<double>(0.0, static_cast<double>(bound))(engine));
+            else
+                return static_cast<T>(engine() % bound);
+        };
+        // Small values, so sums of 10^9 elements do not overflow the signed types.
+        auto bound = distribution == Distribution::FewUnique ? 16 : 1'000;
+        for (auto &value : data)
+            value = draw(bound);
+        if (distribution == Distribution::Sorted)
+            std::sort(data.begin(), data.end());
+        else if (distribution == Distribution::Reversed)
+            std::sort(data.begin(), data.end(), std::greater<>());
+        return data;
+    }
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "s0_benchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "s0_thread_pool.hpp"
+
+namespace
+{
+    using s0m4b0dY::benchmark::Case;
+    using s0m4b0dY::benchmark::Suite;
+    using s0m4b0dY::benchmark::toString;
+    using s0m4b0dY::ThreadPool;
+    using Clock_t = std::chrono::steady_clock;
+
+    void runThroughput(Suite &suite, ThreadPool &pool, std::size_t tasks)
+    {
+        Case benchmarkCase{"", "s0", "task", "", tasks, pool.size(), std::string(toString(pool.scheduling()))};
+        std::atomic<std::size_t> executed = 0;
+        auto task = [&executed]() { executed.fetch_add(1, std::memory_order_relaxed); };
+
+        benchmarkCase.name = "pool_submit";
+        if (suite.selected(benchmarkCase.name))
+            suite.measure(benchmarkCase, [&pool, &task, tasks]()
+                {
+                    std::vector<std::future<void>> futures;
+                    futures.reserve(tasks);
+                    for (std::size_t i = 0; i < tasks; ++i)
+                        futures.push_back(pool.submit(task));
+                    for (auto &future : futures)
+                        future.get();
+                });
+
+        benchmarkCase.name = "pool_post";
+        if (suite.selected(benchmarkCase.name))
+            suite.measure(benchmarkCase, [&pool, &task, tasks]()
+                {
+                    for (std::size_t i = 0; i < tasks; ++i)
+                        pool.post(task);
+                    pool.waitIdle();
+                });
+
+        // Posted from a worker, so with work stealing the tasks go through its own deque and get stolen from there.
+        benchmarkCase.name = "pool_nested_post";
+        if (suite.selected(benchmarkCase.name))
+            suite.measure(benchmarkCase, [&pool, &task, tasks]()
+                {
+                    pool.post([&pool, &task, tasks]()
+                        {
+                            for (std::size_t i = 0; i < tasks; ++i)
+                                pool.post(task);
+                        });
+                    pool.waitIdle();
+                });
+
+        // Every worker posts its share at once. They all contend on the shared queue, or with work stealing
+        // push to their own deques and steal from each other.
+        benchmarkCase.name = "pool_contended_post";
+        if (suite.selected(benchmarkCase.name))
+            suite.measure(benchmarkCase, [&pool, &task, tasks]()
+                {
+                    for (std::size_t producer = 0; producer < pool.size(); ++producer)
+                    {
+                        auto share = tasks / pool.size() + (producer < tasks % pool.size() ? 1 : 0);
+                        pool.post([&pool, &task, share]()
+                            {
+                                for (std::size_t i = 0; i < share; ++i)
+                                    pool.post(task);
+                            });
+                    }
+                    pool.waitIdle();
+                });
+    }
+
+    /**
+     * @brief Fork-joins of one empty task per worker, once with parking workers and once with the default IdleStrategy.
+     * size is the number of round trips, so items_per_second is round trips per second.
+     */
+    void runForkJoin(Suite &suite, ThreadPool &pool, std::size_t rounds)
+    {
+        auto strategy = pool.idleStrategy();
+        for (auto [name, idle] : {std::pair{"pool_fork_join_park", ThreadPool::IdleStrategy::park()},
+                                  std::pair{"pool_fork_join_spin", ThreadPool::IdleStrategy()}})
+        {
+            Case benchmarkCase{name, "s0", "task", "", rounds, pool.size(), std::string(toString(pool.scheduling()))};
+            if (not suite.selected(benchmarkCase.name))
+                continue;
+            pool.setIdleStrategy(idle);
+            suite.measure(benchmarkCase, [&pool, rounds]()
+                {
+                    for (std::size_t round = 0; round < rounds; ++round)
+                    {
+                        s0m4b0dY::TaskGroup group(pool);
+                        for (std::size_t i = 0; i < pool.size(); ++i)
+                            group.run([]() {});
+                        group.wait();
+                    }
+                });
+        }
+        pool.setIdleStrategy(strategy);
+    }
+
+    /**
+     * @brief One task at a time from outside the pool: submit() to task start, and submit() to future.get() returning.
+     * Every round trip is a sample, size is 1 so items_per_second is round trips per second.
+     */
+    void runLatency(Suite &suite, ThreadPool &pool, std::size_t tasks)
+    {
+        s0m4b0dY::benchmark::Result result{Case{"pool_submit_latency", "s0", "task", "", 1, pool.size(), std::string(toString(pool.scheduling()))}, {}, {}};
+        if (not suite.selected(result.benchmarkCase.name))
+            return;
+        std::vector<double> startLatencies;
+        startLatencies.reserve(tasks);
+        result.samplesNs.reserve(tasks);
+        for (std::size_t i = 0; i < tasks; ++i)
+        {
+            auto submitted = Clock_t::now();
+            auto started = pool.submit([]() { return Clock_t::now(); }).get();
+            auto finished = Clock_t::now();
+            startLatencies.push_back(std::chrono::duration<double, std::nano>(started - submitted).count());
+            result.samplesNs.push_back(std::chrono::duration<double, std::nano>(finished - submitted).count());
+        }
+        std::sort(startLatencies.begin(), startLatencies.end());
+        result.extra = {{"tasks", static_cast<double>(tasks)},
+                        {"start_p50_ns", startLatencies[startLatencies.size() / 2]},
+                        {"start_p99_ns", startLatencies[startLatencies.size() * 99 / 100]},
+                        {"start_max_ns", startLatencies.back()}};
+        suite.record(std::move(result));
+    }
+}
+
+void s0m4b0dY::benchmark::runThreadPoolBenchmarks(Suite &suite)
+{
+    const auto &options = suite.options();
+    for (auto threads : options.threads)
+    {
+        for (auto scheduling : {ThreadPool::Scheduling::SharedQueue, ThreadPool::Scheduling::WorkStealing})
+        {
+            ThreadPool pool(static_cast<int>(threads), scheduling);
+            for (auto tasks : options.sizes(options.maxTasks))
+                runThroughput(suite, pool, tasks);
+            runLatency(suite, pool, std::min<std::size_t>(options.maxTasks, 10'000));
+            runForkJoin(suite, pool, std::min<std::size_t>(options.maxTasks, 2'000));
+        }
+    }
+}
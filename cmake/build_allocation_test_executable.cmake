@@ -0,0 +1,11 @@
+set(ALLOCATION_TEST_TARGET "s0m4b0dY_parallel_algorithms_allocation_test")
+
+# Separate from the other tests: it replaces the global operator new to count every allocation of the process.
+add_executable(${ALLOCATION_TEST_TARGET}
+    gtest/src/main.cpp
+    gtest/allocation/s0_allocation_test.cpp
+)
+
+target_link_libraries(${ALLOCATION_TEST_TARGET} PRIVATE ${main_lib} gtest)
+
+target_compile_features(${ALLOCATION_TEST_TARGET} PRIVATE cxx_std_20)
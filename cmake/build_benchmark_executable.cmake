@@ -0,0 +1,21 @@
+set(BENCHMARK_TARGET "s0m4b0dY_parallel_algorithms_benchmark")
+
+# libstdc++ runs std::execution::par on TBB, without it the std::par baseline is sequential.
+find_package(TBB QUIET)
+
+add_executable(${BENCHMARK_TARGET}
+    benchmark/src/main.cpp
+    benchmark/src/s0_benchmark.cpp
+    benchmark/src/s0_algorithm_benchmarks.cpp
+    benchmark/src/s0_thread_pool_benchmarks.cpp
+)
+
+target_include_directories(${BENCHMARK_TARGET} PRIVATE benchmark/src)
+
+target_link_libraries(${BENCHMARK_TARGET} PRIVATE ${main_lib})
+
+if (TBB_FOUND)
+    target_link_libraries(${BENCHMARK_TARGET} PRIVATE TBB::tbb)
+endif()
+
+target_compile_features(${BENCHMARK_TARGET} PRIVATE cxx_std_20)
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "s0_thread_pool.hpp"
+
+// Built as its own executable: replacing the global operator new counts every allocation of the process,
+// which must not leak into the other tests.
+namespace
+{
+    std::atomic<std::size_t> allocationCount = 0;
+
+    void *allocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (void *pointer = std::malloc(size == 0 ? 1 : size))
+            return pointer;
+        throw std::bad_alloc();
+    }
+
+    void *allocate(std::size_t size, std::align_val_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc wants a multiple of the alignment.
+        if (void *pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+            return pointer;
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+TEST(threadPool, steadyStateSubmitAllocations)
+{
+    s0m4b0dY::ThreadPool pool(2);
+    std::atomic<int> counter = 0;
+    auto round = [&pool, &counter]()
+    {
+        s0m4b0dY::TaskGroup group(pool);
+        for (auto i = 0; i < 64; i++)
+        {
+            group.run([&pool, &counter]()
+                {
+                    pool.post([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                });
+        }
+        auto future = pool.submit([&counter]() { return counter.load(); });
+        pool.wait(future);
+        group.wait();
+    };
+    for (auto i = 0; i < 100; i++)
+        round();
+    // Warming up the caches went through the heap, so the replacement is wired up.
+    ASSERT_GT(allocationCount.load(), 0);
+
+    auto allocationsBefore = allocationCount.load();
+    constexpr int rounds = 1000;
+    for (auto i = 0; i < rounds; i++)
+        round();
+    auto allocations = allocationCount.load() - allocationsBefore;
+
+    constexpr int tasks = rounds * 129;
+    // Counts everything on the submit and post path: queues, promises and Task spills alike.
+    // Blocks parked in another thread's cache can force a rare refill from the heap,
+    // but steady state must stay far below one allocation per task.
+    ASSERT_LT(allocations, tasks / 1000);
+}
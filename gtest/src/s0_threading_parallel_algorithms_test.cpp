@@ -3,8 +3,19 @@
 #include <ranges>
 #include <vector>
 #include <numeric>
+#include <string>
+#include <memory>
+#include <execution>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
 
 #include "s0_parallel_algorithms_threading.hpp"
+#include "s0_pipeline.hpp"
 
 TEST(reduce, VectorOf500Elements)
 {
@@ -25,6 +36,164 @@ TEST(reduce, VectorOf500ElementsInitValuePassed)
     ASSERT_EQ(result, initValue + std::reduce(arr.begin(), arr.end()));
 }
 
+TEST(reduce, simdKernelsMatchScalarOnEveryIsa)
+{
+    std::vector<int> ints(100003);
+    std::vector<std::uint64_t> longs(100003);
+    std::vector<long long> longLongs(100003);
+    for (std::size_t i = 0; i < ints.size(); i++)
+    {
+        ints[i] = static_cast<int>(i * 7919 % 2001) - 1000;
+        longs[i] = i * 1000003ull;
+        longLongs[i] = static_cast<long long>(i * 7919 % 2001) * 1000003 - 1000000000;
+    }
+    static_assert(s0m4b0dY::simd::isSummable<long long>);
+    auto supported = s0m4b0dY::simd::supportedIsa();
+    s0m4b0dY::Threading threading;
+    for (auto isa : {s0m4b0dY::simd::Isa::Scalar, s0m4b0dY::simd::Isa::Avx2, s0m4b0dY::simd::Isa::Avx512})
+    {
+        s0m4b0dY::simd::setActiveIsa(isa);
+        ASSERT_EQ(threading.reduce(ints.begin(), ints.end()), std::reduce(ints.begin(), ints.end()));
+        ASSERT_EQ(threading.reduce(longs.begin(), longs.end(), std::uint64_t(5)), std::reduce(longs.begin(), longs.end(), std::uint64_t(5)));
+        ASSERT_EQ(threading.reduce(longLongs.begin(), longLongs.end()), std::reduce(longLongs.begin(), longLongs.end()));
+    }
+    s0m4b0dY::simd::setActiveIsa(supported);
+}
+
+TEST(reduce, floatSummationModes)
+{
+    std::vector<float> arr(1 << 20, 0.1f);
+    double exact = 0.1f * static_cast<double>(arr.size());
+    s0m4b0dY::Threading threading;
+    auto ordered = threading.reduce(arr.begin(), arr.end(), s0m4b0dY::FloatSummation::Ordered);
+    auto reassociated = threading.reduce(arr.begin(), arr.end(), s0m4b0dY::FloatSummation::Reassociate);
+    auto pairwise = threading.reduce(arr.begin(), arr.end(), 0.0f, s0m4b0dY::FloatSummation::Pairwise);
+    ASSERT_NEAR(pairwise, exact, exact * 1e-6);
+    ASSERT_LE(std::abs(pairwise - exact), std::abs(ordered - exact));
+    ASSERT_NEAR(reassociated, exact, exact * 1e-3);
+}
+
+TEST(reduce, customOperationKeepsOrder)
+{
+    std::vector<std::string> arr;
+    std::string expected = "init";
+    for (auto i = 0; i < 500; i++)
+    {
+        arr.push_back(std::to_string(i % 10));
+        expected += arr.back();
+    }
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    auto result = threading.reduce(arr.begin(), arr.end(), std::string("init"), std::plus<>());
+    ASSERT_EQ(result, expected);
+}
+
+TEST(reduce, emptyRangeReturnsInitValue)
+{
+    std::vector<int> arr;
+    s0m4b0dY::Threading threading;
+    ASSERT_EQ(threading.reduce(arr.begin(), arr.end(), 7, std::multiplies<>()), 7);
+    ASSERT_EQ(threading.transform_reduce(arr.begin(), arr.end(), arr.begin(), 3), 3);
+}
+
+TEST(transformReduce, sumOfSquares)
+{
+    auto range = std::ranges::views::iota(0, 500);
+    std::vector<int> arr(range.begin(), range.end());
+    s0m4b0dY::Threading threading;
+    auto square = [](int value) { return static_cast<long long>(value) * value; };
+    auto result = threading.transform_reduce(arr.begin(), arr.end(), 0ll, std::plus<>(), square);
+    ASSERT_EQ(result, std::transform_reduce(arr.begin(), arr.end(), 0ll, std::plus<>(), square));
+}
+
+TEST(transformReduce, dotProduct)
+{
+    auto range = std::ranges::views::iota(0, 503);
+    std::vector<long long> lhs(range.begin(), range.end());
+    std::vector<long long> rhs(lhs.rbegin(), lhs.rend());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::guided(16));
+    auto result = threading.transform_reduce(lhs.begin(), lhs.end(), rhs.begin(), 10ll);
+    ASSERT_EQ(result, std::transform_reduce(lhs.begin(), lhs.end(), rhs.begin(), 10ll));
+}
+
+TEST(minMaxElement, positionsOfDuplicatesMatchStd)
+{
+    std::vector<int> arr;
+    for (auto i = 0; i < 1000; i++)
+        arr.push_back((i * 37) % 101);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::guided(16));
+    ASSERT_EQ(threading.min_element(arr.begin(), arr.end()), std::min_element(arr.begin(), arr.end()));
+    ASSERT_EQ(threading.max_element(arr.begin(), arr.end()), std::max_element(arr.begin(), arr.end()));
+    ASSERT_EQ(threading.minmax_element(arr.begin(), arr.end()), std::minmax_element(arr.begin(), arr.end()));
+    ASSERT_EQ(threading.max_element(arr.begin(), arr.end(), std::greater<>()), std::max_element(arr.begin(), arr.end(), std::greater<>()));
+    ASSERT_EQ(threading.min_element(arr.end(), arr.end()), arr.end());
+}
+
+TEST(scan, inclusiveAndExclusiveMatchStd)
+{
+    auto range = std::ranges::views::iota(0, 1003);
+    std::vector<long long> arr(range.begin(), range.end());
+    std::vector<long long> outputArr(arr.size());
+    std::vector<long long> expectedArr(arr.size());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::guided(16));
+
+    auto outputEnd = threading.inclusive_scan(arr.begin(), arr.end(), outputArr.begin());
+    std::inclusive_scan(arr.begin(), arr.end(), expectedArr.begin());
+    ASSERT_EQ(outputEnd, outputArr.end());
+    ASSERT_EQ(outputArr, expectedArr);
+
+    threading.inclusive_scan(arr.begin(), arr.end(), outputArr.begin(), std::plus<>(), 100ll);
+    std::inclusive_scan(arr.begin(), arr.end(), expectedArr.begin(), std::plus<>(), 100ll);
+    ASSERT_EQ(outputArr, expectedArr);
+
+    threading.exclusive_scan(arr.begin(), arr.end(), outputArr.begin(), 7ll);
+    std::exclusive_scan(arr.begin(), arr.end(), expectedArr.begin(), 7ll);
+    ASSERT_EQ(outputArr, expectedArr);
+}
+
+TEST(scan, nonCommutativeOperationInPlace)
+{
+    std::vector<std::string> arr;
+    for (auto i = 0; i < 200; i++)
+        arr.push_back(std::to_string(i % 10));
+    std::vector<std::string> expectedArr(arr.size());
+    std::exclusive_scan(arr.begin(), arr.end(), expectedArr.begin(), std::string(">"), std::plus<>());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    threading.exclusive_scan(arr.begin(), arr.end(), arr.begin(), std::string(">"), std::plus<>());
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(scan, transformScansAndSequentialOutput)
+{
+    auto range = std::ranges::views::iota(0, 500);
+    std::vector<int> arr(range.begin(), range.end());
+    auto square = [](int value) { return static_cast<long long>(value) * value; };
+    std::vector<long long> expectedArr;
+    std::transform_inclusive_scan(arr.begin(), arr.end(), std::back_inserter(expectedArr), std::plus<>(), square);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+
+    std::vector<long long> outputArr(arr.size());
+    threading.transform_inclusive_scan(arr.begin(), arr.end(), outputArr.begin(), std::plus<>(), square);
+    ASSERT_EQ(outputArr, expectedArr);
+
+    std::list<long long> outputList;
+    threading.transform_inclusive_scan(arr.begin(), arr.end(), std::back_inserter(outputList), std::plus<>(), square);
+    ASSERT_TRUE(std::equal(outputList.begin(), outputList.end(), expectedArr.begin(), expectedArr.end()));
+
+    std::vector<long long> expectedExclusive(arr.size());
+    std::transform_exclusive_scan(arr.begin(), arr.end(), expectedExclusive.begin(), 1ll, std::plus<>(), square);
+    threading.transform_exclusive_scan(arr.begin(), arr.end(), outputArr.begin(), 1ll, std::plus<>(), square);
+    ASSERT_EQ(outputArr, expectedExclusive);
+
+    std::vector<int> empty;
+    ASSERT_EQ(threading.inclusive_scan(empty.begin(), empty.end(), outputArr.begin()), outputArr.begin());
+}
+
 TEST(findIf, SearchWithLambda)
 {
     auto range = std::ranges::views::iota(0, 500);
@@ -47,6 +216,56 @@ TEST(findIf, SearchWithLambdaNonExistValue)
     ASSERT_EQ(result, arr.end());
 }
 
+TEST(findIf, returnsLeftmostMatch)
+{
+    std::vector<int> arr(100000, 0);
+    arr[99000] = 1;
+    arr[60000] = 1;
+    arr[30001] = 1;
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    for (auto repeat = 0; repeat < 20; repeat++)
+    {
+        ASSERT_EQ(threading.find_if(arr.begin(), arr.end(), [](int value){return value == 1;}) - arr.begin(), 30001);
+        ASSERT_EQ(threading.find(arr.begin(), arr.end(), 1) - arr.begin(), 30001);
+    }
+    ASSERT_EQ(threading.find(arr.begin(), arr.end(), 2), arr.end());
+}
+
+TEST(findIf, anyAllNoneOf)
+{
+    auto range = std::ranges::views::iota(0, 5000);
+    std::vector<int> arr(range.begin(), range.end());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    auto isNegative = [](int value){return value < 0;};
+    auto isLast = [](int value){return value == 4999;};
+    ASSERT_FALSE(threading.any_of(arr.begin(), arr.end(), isNegative));
+    ASSERT_TRUE(threading.none_of(arr.begin(), arr.end(), isNegative));
+    ASSERT_TRUE(threading.any_of(arr.begin(), arr.end(), isLast));
+    ASSERT_FALSE(threading.all_of(arr.begin(), arr.end(), isLast));
+    ASSERT_TRUE(threading.all_of(arr.begin(), arr.end(), [](int value){return value >= 0;}));
+    ASSERT_TRUE(threading.all_of(arr.end(), arr.end(), isLast));
+}
+
+TEST(mismatch, leftmostDifferenceAndEqual)
+{
+    std::list<int> lhs;
+    for (auto i = 0; i < 5000; i++)
+        lhs.push_back(i);
+    std::vector<int> rhs(lhs.begin(), lhs.end());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    ASSERT_TRUE(threading.equal(lhs.begin(), lhs.end(), rhs.begin()));
+    ASSERT_FALSE(threading.equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end() - 1));
+    rhs[4000] = -1;
+    rhs[1234] = -1;
+    auto [lhsIt, rhsIt] = threading.mismatch(lhs.begin(), lhs.end(), rhs.begin());
+    ASSERT_EQ(rhsIt - rhs.begin(), 1234);
+    ASSERT_EQ(*lhsIt, 1234);
+    ASSERT_FALSE(threading.equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+}
+
 TEST(countIf, valueLess250Test)
 {
     auto range = std::ranges::views::iota(0, 500);
@@ -80,6 +299,85 @@ TEST(countIf, alwaysTrueTest)
     ASSERT_EQ(result, arr.size());
 }
 
+TEST(countIf, contiguousRangeRemainder)
+{
+    auto range = std::ranges::views::iota(0, 503);
+    std::vector<int> arr(range.begin(), range.end());
+    s0m4b0dY::Threading threading;
+    auto isOdd = [](int value){return value % 2 != 0;};
+    ASSERT_EQ(threading.count_if(arr.begin(), arr.end(), isOdd), std::count_if(arr.begin(), arr.end(), isOdd));
+}
+
+TEST(copyIf, matchesStdForEveryOutputKind)
+{
+    auto range = std::ranges::views::iota(0, 1003);
+    std::vector<int> arr(range.begin(), range.end());
+    auto isOdd = [](int value){return value % 3 == 1;};
+    std::vector<int> expectedArr;
+    std::copy_if(arr.begin(), arr.end(), std::back_inserter(expectedArr), isOdd);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::guided(16));
+
+    std::vector<int> outputArr(arr.size());
+    auto outputEnd = threading.copy_if(arr.begin(), arr.end(), outputArr.begin(), isOdd);
+    ASSERT_TRUE(std::equal(outputArr.begin(), outputEnd, expectedArr.begin(), expectedArr.end()));
+
+    std::vector<int> backInserted{-1};
+    threading.copy_if(arr.begin(), arr.end(), std::back_inserter(backInserted), isOdd);
+    ASSERT_EQ(backInserted.front(), -1);
+    ASSERT_TRUE(std::equal(backInserted.begin() + 1, backInserted.end(), expectedArr.begin(), expectedArr.end()));
+
+    std::list<int> outputList;
+    threading.copy_if(arr.begin(), arr.end(), std::back_inserter(outputList), isOdd);
+    ASSERT_TRUE(std::equal(outputList.begin(), outputList.end(), expectedArr.begin(), expectedArr.end()));
+}
+
+TEST(removeIf, keepsOrderOfRemainingElements)
+{
+    std::vector<std::string> arr;
+    for (auto i = 0; i < 1003; i++)
+        arr.push_back(std::to_string(i));
+    auto expectedArr = arr;
+    auto isRemoved = [](const std::string &value){return value.back() == '3' or value.size() == 2;};
+    expectedArr.erase(std::remove_if(expectedArr.begin(), expectedArr.end(), isRemoved), expectedArr.end());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    arr.erase(threading.remove_if(arr.begin(), arr.end(), isRemoved), arr.end());
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(partition, splitsEveryElementOnce)
+{
+    std::vector<int> arr;
+    for (auto i = 0; i < 1003; i++)
+        arr.push_back((i * 7919) % 1003);
+    auto isSmall = [](int value){return value < 300 or (value > 600 and value < 700);};
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    auto sorted = arr;
+    std::sort(sorted.begin(), sorted.end());
+    auto middle = threading.partition(arr.begin(), arr.end(), isSmall);
+    ASSERT_EQ(middle - arr.begin(), std::count_if(arr.begin(), arr.end(), isSmall));
+    ASSERT_TRUE(std::is_partitioned(arr.begin(), arr.end(), isSmall));
+    std::sort(arr.begin(), arr.end());
+    ASSERT_EQ(arr, sorted);
+}
+
+TEST(stablePartition, keepsOrderInsideGroups)
+{
+    std::vector<std::pair<int, int> > arr;
+    for (auto i = 0; i < 1003; i++)
+        arr.emplace_back((i * 7919) % 5, i);
+    auto isEven = [](const std::pair<int, int> &value){return value.first % 2 == 0;};
+    auto expectedArr = arr;
+    std::stable_partition(expectedArr.begin(), expectedArr.end(), isEven);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    auto middle = threading.stable_partition(arr.begin(), arr.end(), isEven);
+    ASSERT_EQ(middle - arr.begin(), std::count_if(arr.begin(), arr.end(), isEven));
+    ASSERT_EQ(arr, expectedArr);
+}
+
 TEST(transform, increaseBy500)
 {
     auto range = std::ranges::views::iota(0, 500);
@@ -110,20 +408,84 @@ TEST(transformNonBackInserter, increaseBy500)
     ASSERT_TRUE(result);
 }
 
-// TEST(transformSecondOverload_adder, plus)
-// {
-//     auto range1 = std::ranges::views::iota(0, 500);
-//     auto range2 = std::ranges::views::iota(500, 1000);
-//     std::vector<int> arr1(range1.begin(), range1.end());
-//     std::vector<int> arr2(range2.begin(), range2.end());
-//     std::vector<int> outputArr;
-//     std::vector<int> expectedArr;
-//     std::transform(arr1.begin(), arr1.end(), arr2.begin(), std::back_inserter(expectedArr), std::plus());
-//     s0m4b0dY::Threading threading;
-//     threading.transform(arr1.begin(), arr1.end(), arr2.begin(), std::back_inserter(outputArr), std::plus());
-//     auto result = std::equal(outputArr.begin(), outputArr.end(), outputArr.begin(), outputArr.end());
-//     ASSERT_TRUE(result);
-// }
+TEST(transformSecondOverload_adder, plus)
+{
+    auto range1 = std::ranges::views::iota(0, 500);
+    auto range2 = std::ranges::views::iota(500, 1000);
+    std::vector<int> arr1(range1.begin(), range1.end());
+    std::vector<int> arr2(range2.begin(), range2.end());
+    std::vector<int> outputArr;
+    std::vector<int> expectedArr;
+    std::transform(arr1.begin(), arr1.end(), arr2.begin(), std::back_inserter(expectedArr), std::minus());
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    threading.transform(arr1.begin(), arr1.end(), arr2.begin(), std::back_inserter(outputArr), std::minus());
+    ASSERT_EQ(outputArr, expectedArr);
+}
+
+TEST(transform, appendsToNonEmptyVector)
+{
+    auto range = std::ranges::views::iota(0, 503);
+    std::vector<int> arr(range.begin(), range.end());
+    std::vector<int> outputArr{-1, -2};
+    std::vector<int> expectedArr{-1, -2};
+    auto twice = [](int value){return value * 2;};
+    std::transform(arr.begin(), arr.end(), std::back_inserter(expectedArr), twice);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    threading.transform(arr.begin(), arr.end(), std::back_inserter(outputArr), twice);
+    ASSERT_EQ(outputArr, expectedArr);
+}
+
+TEST(transform, sequentialOutputKeepsOrder)
+{
+    auto range = std::ranges::views::iota(0, 503);
+    std::vector<int> arr(range.begin(), range.end());
+    std::list<std::string> outputList;
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    threading.transform(arr.begin(), arr.end(), std::back_inserter(outputList), [](int value){return std::to_string(value);});
+    ASSERT_EQ(outputList.size(), arr.size());
+    ASSERT_TRUE(std::equal(outputList.begin(), outputList.end(), arr.begin(), [](const std::string &lhs, int rhs) { return lhs == std::to_string(rhs); }));
+}
+
+TEST(transform, vectorOfBoolIsNotFilledInPlace)
+{
+    // Neighbouring bits share a word, chunks writing them in place would race.
+    static_assert(not s0m4b0dY::ResizableBackInserter<std::back_insert_iterator<std::vector<bool>>>);
+    static_assert(s0m4b0dY::ResizableBackInserter<std::back_insert_iterator<std::vector<char>>>);
+    auto range = std::ranges::views::iota(0, 5003);
+    std::vector<int> arr(range.begin(), range.end());
+    auto isOdd = [](int value){return value % 2 == 1;};
+    std::vector<bool> expectedArr{true};
+    std::transform(arr.begin(), arr.end(), std::back_inserter(expectedArr), isOdd);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(3));
+    std::vector<bool> outputArr{true};
+    threading.transform(arr.begin(), arr.end(), std::back_inserter(outputArr), isOdd);
+    ASSERT_EQ(outputArr, expectedArr);
+
+    std::vector<bool> copied;
+    std::vector<bool> flags(expectedArr.begin(), expectedArr.end());
+    threading.copy_if(flags.begin(), flags.end(), std::back_inserter(copied), [](bool flag){return flag;});
+    ASSERT_EQ(copied, std::vector<bool>(std::count(flags.begin(), flags.end(), true), true));
+}
+
+TEST(transform, exceptionRestoresBackInsertedContainer)
+{
+    auto range = std::ranges::views::iota(0, 500);
+    std::vector<int> arr(range.begin(), range.end());
+    std::vector<int> outputArr{1, 2, 3};
+    s0m4b0dY::Threading threading;
+    auto throwing = [](int value) -> int
+    {
+        if (value == 250)
+            throw std::runtime_error("transform failed");
+        return value;
+    };
+    ASSERT_THROW(threading.transform(arr.begin(), arr.end(), std::back_inserter(outputArr), throwing), std::runtime_error);
+    ASSERT_EQ(outputArr, (std::vector<int>{1, 2, 3}));
+}
 
 TEST(transformSecondOverloadNonBackInserter, plus)
 {
@@ -140,6 +502,155 @@ TEST(transformSecondOverloadNonBackInserter, plus)
     ASSERT_TRUE(result);
 }
 
+TEST(forEach, visitsEveryElementOnce)
+{
+    std::vector<int> arr(1003, 1);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    threading.for_each(arr.begin(), arr.end(), [](int &value){value *= 3;});
+    ASSERT_EQ(std::count(arr.begin(), arr.end(), 3), arr.size());
+    auto last = threading.for_each_n(arr.begin(), 500, [](int &value){value = 0;});
+    ASSERT_EQ(last - arr.begin(), 500);
+    ASSERT_EQ(std::count(arr.begin(), arr.end(), 0), 500);
+}
+
+TEST(generateAndFill, writeEveryElement)
+{
+    std::vector<int> arr(1003);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::guided(16));
+    std::atomic<int> calls = 0;
+    threading.generate(arr.begin(), arr.end(), [&calls](){return ++calls;});
+    ASSERT_EQ(calls, arr.size());
+    std::sort(arr.begin(), arr.end());
+    auto range = std::ranges::views::iota(1, 1004);
+    ASSERT_TRUE(std::equal(arr.begin(), arr.end(), range.begin(), range.end()));
+    threading.fill(arr.begin(), arr.end(), 42);
+    ASSERT_EQ(std::count(arr.begin(), arr.end(), 42), arr.size());
+}
+
+TEST(parallelFor, blockedRangesCoverIndexSpace)
+{
+    std::vector<std::atomic<int> > hits(1000);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool);
+    threading.parallel_for(-500, 500, 64, [&hits](s0m4b0dY::BlockedRange<int> range)
+    {
+        ASSERT_LE(range.size(), 64);
+        for (auto i = range.begin(); i != range.end(); ++i)
+            hits[i + 500]++;
+    });
+    ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int> &value){return value == 1;}));
+    std::size_t visited = 0;
+    threading.parallel_for(std::size_t(10), std::size_t(10), [&visited](s0m4b0dY::BlockedRange<std::size_t> range) { visited += range.size(); });
+    ASSERT_EQ(visited, 0);
+    std::atomic<std::size_t> total = 0;
+    threading.parallel_for(std::size_t(0), std::size_t(100000), [&total](s0m4b0dY::BlockedRange<std::size_t> range) { total += range.size(); });
+    ASSERT_EQ(total, 100000);
+}
+
+TEST(tileSequence, everyOrderIsPermutation)
+{
+    for (auto order : {s0m4b0dY::TileOrder::RowMajor, s0m4b0dY::TileOrder::Morton, s0m4b0dY::TileOrder::Hilbert})
+    {
+        std::vector<std::size_t> counts{5, 3, 7};
+        auto sequence = s0m4b0dY::tileSequence(counts, order);
+        std::vector<std::size_t> expected(5 * 3 * 7);
+        std::iota(expected.begin(), expected.end(), std::size_t(0));
+        std::sort(sequence.begin(), sequence.end());
+        ASSERT_EQ(sequence, expected);
+    }
+}
+
+TEST(tileSequence, hilbertStepsToNeighbours)
+{
+    for (std::vector<std::size_t> counts : {std::vector<std::size_t>{8, 8}, std::vector<std::size_t>{4, 4, 4}})
+    {
+        auto sequence = s0m4b0dY::tileSequence(counts, s0m4b0dY::TileOrder::Hilbert);
+        for (std::size_t i = 1; i < sequence.size(); ++i)
+        {
+            std::size_t distance = 0;
+            auto lhs = sequence[i - 1], rhs = sequence[i];
+            for (auto d = counts.size(); d-- > 0;)
+            {
+                distance += std::max(lhs % counts[d], rhs % counts[d]) - std::min(lhs % counts[d], rhs % counts[d]);
+                lhs /= counts[d];
+                rhs /= counts[d];
+            }
+            ASSERT_EQ(distance, 1);
+        }
+    }
+}
+
+TEST(parallelFor, tiles2dAnd3dCoverEveryCellOnce)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool);
+    for (auto order : {s0m4b0dY::TileOrder::RowMajor, s0m4b0dY::TileOrder::Morton, s0m4b0dY::TileOrder::Hilbert})
+    {
+        std::vector<std::atomic<int> > hits(37 * 53);
+        s0m4b0dY::BlockedRange2d<int> range({0, 37}, {0, 53});
+        threading.parallel_for(range, 8, 16, [&hits](s0m4b0dY::BlockedRange2d<int> tile)
+        {
+            ASSERT_LE(tile.rows().size(), 8);
+            ASSERT_LE(tile.cols().size(), 16);
+            for (auto row = tile.rows().begin(); row != tile.rows().end(); ++row)
+                for (auto col = tile.cols().begin(); col != tile.cols().end(); ++col)
+                    hits[row * 53 + col]++;
+        }, order);
+        ASSERT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int> &value){return value == 1;}));
+
+        std::vector<std::atomic<int> > hits3d(5 * 9 * 11);
+        s0m4b0dY::BlockedRange3d<std::size_t> range3d({0, 5}, {0, 9}, {0, 11});
+        threading.parallel_for(range3d, 2, 4, 4, [&hits3d](s0m4b0dY::BlockedRange3d<std::size_t> tile)
+        {
+            for (auto page = tile.pages().begin(); page != tile.pages().end(); ++page)
+                for (auto row = tile.rows().begin(); row != tile.rows().end(); ++row)
+                    for (auto col = tile.cols().begin(); col != tile.cols().end(); ++col)
+                        hits3d[(page * 9 + row) * 11 + col]++;
+        }, order);
+        ASSERT_TRUE(std::all_of(hits3d.begin(), hits3d.end(), [](const std::atomic<int> &value){return value == 1;}));
+    }
+}
+
+TEST(threading, nodeLocalPlacementRunsChunksOnTheirNode)
+{
+    s0m4b0dY::Topology topology({{0, {0}}, {1, {0}}});
+    s0m4b0dY::ThreadPool pool(4, s0m4b0dY::ThreadPool::Scheduling::WorkStealing, s0m4b0dY::ThreadPool::Affinity::Spread, topology);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(100), s0m4b0dY::MemoryPlacement::NodeLocal);
+
+    std::vector<std::size_t> nodes(1000);
+    threading.parallel_for(std::size_t(0), nodes.size(), [&pool, &nodes](s0m4b0dY::BlockedRange<std::size_t> range)
+    {
+        for (auto i = range.begin(); i != range.end(); ++i)
+            nodes[i] = pool.workerNode(pool.currentWorkerIndex());
+    });
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        ASSERT_EQ(nodes[i], i < 500 ? 0 : 1);
+
+    std::vector<int> values(1000);
+    threading.fill(values.begin(), values.end(), 3);
+    ASSERT_EQ(threading.with(s0m4b0dY::Partitioner::staticPartition()).reduce(values.begin(), values.end()), 3000);
+    ASSERT_EQ(threading.with(s0m4b0dY::Partitioner::guided()).placement(), s0m4b0dY::MemoryPlacement::NodeLocal);
+}
+
+TEST(threading, priorityPropagatesToChunks)
+{
+    s0m4b0dY::ThreadPool pool(2);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(16));
+    auto urgent = threading.with(s0m4b0dY::ThreadPool::Priority::High);
+    ASSERT_EQ(urgent.with(s0m4b0dY::Partitioner::guided()).priority(), s0m4b0dY::ThreadPool::Priority::High);
+    std::vector<int> values(1000);
+    std::atomic<int> wrongPriority = 0;
+    urgent.for_each(values.begin(), values.end(), [&wrongPriority](int &)
+    {
+        wrongPriority += s0m4b0dY::ThreadPool::currentPriority() != s0m4b0dY::ThreadPool::Priority::High;
+    });
+    ASSERT_EQ(wrongPriority, 0);
+    urgent.with(s0m4b0dY::Partitioner::fixedGrain(300)).sort(values.begin(), values.end(), std::less<>(), 64);
+    ASSERT_EQ(s0m4b0dY::ThreadPool::currentPriority(), s0m4b0dY::ThreadPool::Priority::Normal);
+}
+
 TEST(bitonicSort, 500_0_range)
 {
     std::vector<int> arr;
@@ -166,11 +677,457 @@ TEST(oddEvenSort, 500_0_range)
     ASSERT_TRUE(std::is_sorted(arr.begin(), arr.end()));
 }
 
+TEST(bitonicSort, stableByFirstMember)
+{
+    std::vector<std::pair<int, int>> arr;
+    for (auto i = 0; i < 256; i++)
+    {
+        arr.emplace_back((i * 7) % 16, i);
+    }
+    auto expectedArr = arr;
+    auto byFirst = [](const std::pair<int, int> &lhs, const std::pair<int, int> &rhs){return lhs.first < rhs.first;};
+    std::stable_sort(expectedArr.begin(), expectedArr.end(), byFirst);
+    s0m4b0dY::Threading threading;
+    threading.bitonic_sort(arr.begin(), arr.end(), byFirst, s0m4b0dY::SortStability::Stable);
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(bitonicSort, stableAboveMergeGrainSize)
+{
+    // Long enough for the merge to split into tasks before it goes sequential.
+    std::vector<std::pair<int, int>> arr;
+    for (auto i = 0; i < (1 << 16); i++)
+    {
+        arr.emplace_back((i * 7919) % 1000, i);
+    }
+    auto expectedArr = arr;
+    auto byFirst = [](const std::pair<int, int> &lhs, const std::pair<int, int> &rhs){return lhs.first < rhs.first;};
+    std::stable_sort(expectedArr.begin(), expectedArr.end(), byFirst);
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool);
+    threading.bitonic_sort(arr.begin(), arr.end(), byFirst, s0m4b0dY::SortStability::Stable);
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(oddEvenSort, stringsDescending)
+{
+    std::vector<std::string> arr;
+    for (auto i = 0; i < 100; i++)
+    {
+        arr.push_back(std::to_string((i * 37) % 100));
+    }
+    auto expectedArr = arr;
+    std::sort(expectedArr.begin(), expectedArr.end(), std::greater<std::string>());
+    s0m4b0dY::Threading threading;
+    threading.odd_even_sort(arr.begin(), arr.end(), std::greater<std::string>());
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(oddEvenSort, poolWithoutWorkers)
+{
+    std::vector<int> arr;
+    for (auto i = 0; i < 300; i++)
+    {
+        arr.push_back((i * 37) % 101);
+    }
+    auto expectedArr = arr;
+    std::sort(expectedArr.begin(), expectedArr.end());
+    // The calling thread runs every chunk, before and after resizing down to no workers.
+    s0m4b0dY::ThreadPool pool(0);
+    s0m4b0dY::Threading threading(pool);
+    auto copy = arr;
+    threading.odd_even_sort(copy.begin(), copy.end());
+    ASSERT_EQ(copy, expectedArr);
+    pool.resize(2);
+    pool.resize(0);
+    threading.odd_even_sort(arr.begin(), arr.end());
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(sort, arbitraryLengthWithDuplicates)
+{
+    std::vector<int> arr;
+    for (auto i = 0; i < 100003; i++)
+    {
+        arr.push_back((i * 7919) % 1000);
+    }
+    auto expectedArr = arr;
+    std::sort(expectedArr.begin(), expectedArr.end());
+    s0m4b0dY::Threading threading;
+    threading.sort(arr.begin(), arr.end(), std::less<int>(), 1000);
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(sort, moveOnlyElements)
+{
+    std::vector<std::unique_ptr<int>> arr;
+    for (auto i = 0; i < 5000; i++)
+    {
+        arr.push_back(std::make_unique<int>(5000 - i));
+    }
+    s0m4b0dY::Threading threading;
+    threading.sort(arr.begin(), arr.end(), [](const auto &lhs, const auto &rhs){return *lhs < *rhs;}, 100);
+    ASSERT_TRUE(std::is_sorted(arr.begin(), arr.end(), [](const auto &lhs, const auto &rhs){return *lhs < *rhs;}));
+    ASSERT_EQ(*arr.front(), 1);
+}
+
+TEST(stableSort, keepsOrderOfEqualElements)
+{
+    std::vector<std::pair<int, std::string>> arr;
+    for (auto i = 0; i < 20011; i++)
+    {
+        arr.emplace_back((i * 31) % 97, std::to_string(i));
+    }
+    auto expectedArr = arr;
+    auto byFirst = [](const auto &lhs, const auto &rhs){return lhs.first < rhs.first;};
+    std::stable_sort(expectedArr.begin(), expectedArr.end(), byFirst);
+    s0m4b0dY::Threading threading;
+    threading.stable_sort(arr.begin(), arr.end(), byFirst, 500);
+    ASSERT_EQ(arr, expectedArr);
+}
+
+TEST(radixSort, integralAndFloatingPointKeys)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool);
+    std::vector<std::uint32_t> unsignedKeys(100003);
+    std::vector<std::int64_t> signedKeys(100003);
+    std::vector<float> floatKeys(100003);
+    std::vector<double> doubleKeys(100003);
+    std::uint64_t state = 42;
+    for (std::size_t i = 0; i < unsignedKeys.size(); i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsignedKeys[i] = static_cast<std::uint32_t>(state >> 32);
+        signedKeys[i] = static_cast<std::int64_t>(state);
+        floatKeys[i] = static_cast<float>(static_cast<std::int32_t>(state >> 32)) / 1000.0f;
+        doubleKeys[i] = static_cast<double>(static_cast<std::int64_t>(state)) * 1e-300;
+    }
+    floatKeys[7] = -0.0f;
+    floatKeys[8] = std::numeric_limits<float>::infinity();
+    floatKeys[9] = -std::numeric_limits<float>::infinity();
+
+    auto check = [&threading](auto values)
+    {
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        threading.radix_sort(values.begin(), values.end());
+        ASSERT_EQ(values, expected);
+    };
+    check(unsignedKeys);
+    check(signedKeys);
+    check(floatKeys);
+    check(doubleKeys);
+    // Only the low byte differs, the other passes are skipped.
+    std::vector<std::uint64_t> lowByteKeys;
+    for (auto key : unsignedKeys)
+        lowByteKeys.push_back(key % 256);
+    check(lowByteKeys);
+    // Short inputs go to std::stable_sort.
+    check(std::vector<int>{3, -1, 2, -7, 0});
+    check(std::vector<int>());
+}
+
+TEST(radixSort, stableByKeyOfRecords)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool);
+    struct Record
+    {
+        std::uint32_t key;
+        std::uint32_t position;
+        bool operator==(const Record &) const = default;
+    };
+    std::vector<Record> records;
+    std::vector<std::pair<std::int16_t, std::string>> strings;
+    for (std::uint32_t i = 0; i < 50021; i++)
+    {
+        records.push_back(Record{(i * 7919) % 1009, i});
+        strings.emplace_back(static_cast<std::int16_t>((i * 31) % 97) - 48, std::to_string(i));
+    }
+    auto expectedRecords = records;
+    std::stable_sort(expectedRecords.begin(), expectedRecords.end(), [](const Record &lhs, const Record &rhs) { return lhs.key < rhs.key; });
+    threading.radix_sort(records.begin(), records.end(), &Record::key);
+    ASSERT_EQ(records, expectedRecords);
+
+    // Not trivially copyable, moved instead of copied through the write-combining buffers.
+    auto expectedStrings = strings;
+    std::stable_sort(expectedStrings.begin(), expectedStrings.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    threading.radix_sort(strings.begin(), strings.end(), [](const auto &element) { return element.first; });
+    ASSERT_EQ(strings, expectedStrings);
+}
+
+namespace
+{
+    s0m4b0dY::Async<int> sumAndCount(s0m4b0dY::Threading &threading, const std::vector<int> &values, std::thread::id &resumedOn)
+    {
+        auto sum = co_await threading.async_reduce(values.begin(), values.end(), 0);
+        auto odd = co_await threading.async_count_if(values.begin(), values.end(), [](int value) { return value % 2 != 0; });
+        resumedOn = std::this_thread::get_id();
+        co_return sum + static_cast<int>(odd);
+    }
+}
+
+TEST(async, algorithmsMatchBlockingVersions)
+{
+    s0m4b0dY::ThreadPool pool(3);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(100));
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    ASSERT_EQ(threading.async_reduce(values.begin(), values.end(), 5).get(), threading.reduce(values.begin(), values.end(), 5));
+    ASSERT_EQ(threading.async_reduce(values.begin(), values.end(), 0LL, std::plus<>()).get(), 49995000LL);
+    ASSERT_EQ(threading.async_transform_reduce(values.begin(), values.end(), 0LL, std::plus<>(), [](int value) { return value * 2LL; }).get(), 99990000LL);
+    ASSERT_EQ(threading.async_find_if(values.begin(), values.end(), [](int value) { return value > 7777; }).get(), values.begin() + 7778);
+    ASSERT_EQ(threading.async_find_if(values.begin(), values.end(), [](int value) { return value < 0; }).get(), values.end());
+    std::vector<int> doubled(values.size());
+    ASSERT_EQ(threading.async_transform(values.begin(), values.end(), doubled.begin(), [](int value) { return 2 * value; }).get(), doubled.end());
+    ASSERT_EQ(doubled[1234], 2468);
+    std::atomic<long long> visited = 0;
+    threading.async_for_each(values.begin(), values.end(), [&visited](int value) { visited += value; }).get();
+    ASSERT_EQ(visited, 49995000LL);
+    std::vector<int> empty;
+    ASSERT_EQ(threading.async_reduce(empty.begin(), empty.end(), 3).get(), 3);
+    ASSERT_EQ(threading.async_count_if(empty.begin(), empty.end(), [](int) { return true; }).get(), 0);
+    std::reverse(values.begin(), values.end());
+    threading.async_invoke([&values](s0m4b0dY::Threading &threading) { threading.sort(values.begin(), values.end()); }).get();
+    ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(async, awaitingDoesNotBlockTheCaller)
+{
+    s0m4b0dY::ThreadPool pool(2);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(1000));
+    std::vector<int> values(4000, 1);
+    std::atomic<bool> released = false;
+    auto gated = threading.async_for_each(values.begin(), values.end(), [&released](int)
+    {
+        while (not released.load())
+            std::this_thread::yield();
+    });
+    std::thread::id resumedOn;
+    auto result = [](s0m4b0dY::Async<void> gated, s0m4b0dY::Threading &threading, const std::vector<int> &values, std::thread::id &resumedOn) -> s0m4b0dY::Async<int>
+    {
+        co_await gated;
+        co_return co_await sumAndCount(threading, values, resumedOn);
+    }(std::move(gated), threading, values, resumedOn);
+    // The coroutine is parked on the gated chunks, this thread went on.
+    ASSERT_FALSE(result.ready());
+    released = true;
+    ASSERT_EQ(result.get(), 8000);
+    ASSERT_NE(resumedOn, std::this_thread::get_id());
+}
+
+TEST(async, whenAllOverlapsAlgorithmsAndForwardsExceptions)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(64));
+    std::vector<int> values(5000);
+    std::iota(values.begin(), values.end(), 1);
+    std::atomic<int> visited = 0;
+    auto [sum, count, nothing] = s0m4b0dY::when_all(
+        threading.async_reduce(values.begin(), values.end(), 0),
+        threading.async_count_if(values.begin(), values.end(), [](int value) { return value <= 10; }),
+        threading.async_for_each(values.begin(), values.end(), [&visited](int) { ++visited; })).get();
+    ASSERT_EQ(sum, 12502500);
+    ASSERT_EQ(count, 10);
+    ASSERT_EQ(visited, 5000);
+
+    std::vector<s0m4b0dY::Async<int> > sums;
+    for (int i = 0; i < 8; i++)
+        sums.push_back(threading.async_reduce(values.begin(), values.end(), i));
+    auto allSums = s0m4b0dY::when_all(std::move(sums)).get();
+    ASSERT_EQ(allSums.size(), 8);
+    ASSERT_EQ(allSums[7], 12502507);
+
+    visited = 0;
+    auto failing = s0m4b0dY::when_all(
+        threading.async_for_each(values.begin(), values.end(), [](int value)
+        {
+            if (value == 4321)
+                throw std::runtime_error("chunk failed");
+        }),
+        threading.async_for_each(values.begin(), values.end(), [&visited](int) { ++visited; }));
+    ASSERT_THROW(failing.get(), std::runtime_error);
+    // The exception only surfaces once every algorithm is done with the data.
+    ASSERT_EQ(visited, 5000);
+}
+
+TEST(combinable, oneSlotPerThreadCombinedAtTheEnd)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(500));
+    s0m4b0dY::Combinable<long long> sums(pool);
+    std::vector<int> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+    threading.for_each(values.begin(), values.end(), [&sums](int value) { sums.local() += value; });
+    ASSERT_EQ(sums.combine(std::plus<>()), 4999950000LL);
+    std::size_t slots = 0;
+    sums.combineEach([&slots](long long) { ++slots; });
+    // The four workers and the calling thread at most.
+    ASSERT_GE(slots, 1);
+    ASSERT_LE(slots, 5);
+
+    // Threads outside the pool get a slot each.
+    sums.clear();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([&sums]()
+        {
+            bool exists = true;
+            sums.local(exists) = 0;
+            ASSERT_FALSE(exists);
+            for (int j = 0; j < 1000; j++)
+                ++sums.local(exists);
+            ASSERT_TRUE(exists);
+        });
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(sums.combine(std::plus<>()), 4000);
+
+    s0m4b0dY::Combinable<std::string> unused(pool, []() { return std::string("empty"); });
+    ASSERT_EQ(unused.combine(std::plus<>()), "empty");
+}
+
+TEST(histogram, matchesSequentialCount)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(1000));
+    std::vector<int> values(200000);
+    for (std::size_t i = 0; i < values.size(); i++)
+        values[i] = static_cast<int>((i * 7919) % 1000) - 10;
+    for (std::size_t binCount : {std::size_t(16), std::size_t(1000), std::size_t(100000)})
+    {
+        auto bins = threading.histogram(values.begin(), values.end(), binCount, [](int value) { return value; });
+        std::vector<std::size_t> expected(binCount);
+        for (int value : values)
+        {
+            if (value >= 0 and static_cast<std::size_t>(value) < binCount)
+                ++expected[value];
+        }
+        ASSERT_EQ(bins, expected);
+    }
+    std::vector<int> empty;
+    ASSERT_EQ(threading.histogram(empty.begin(), empty.end(), 3, [](int value) { return value; }), std::vector<std::size_t>(3));
+}
+
+TEST(histogram, dropsNegativeAndOutOfRangeKeys)
+{
+    s0m4b0dY::Threading threading;
+    std::vector<std::int64_t> keys;
+    for (std::int64_t i = 0; i < 100000; i++)
+        keys.push_back(i % 7 - 3);
+    keys.push_back(std::numeric_limits<std::int64_t>::min());
+    keys.push_back(std::numeric_limits<std::int64_t>::max());
+    keys.push_back(4);
+    auto bins = threading.histogram(keys.begin(), keys.end(), 4, [](std::int64_t key) { return key; });
+    // Only 0, 1, 2 and 3 are counted, -3..-1, 4 and the extremes are dropped.
+    ASSERT_EQ(bins, (std::vector<std::size_t>{14286, 14286, 14285, 14285}));
+}
+
+TEST(combinable, callerAndWorkersShareOneRun)
+{
+    s0m4b0dY::ThreadPool pool(4);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(100));
+    struct Counter
+    {
+        std::thread::id owner = std::this_thread::get_id();
+        std::size_t count = 0;
+    };
+    s0m4b0dY::Combinable<Counter> counters(pool);
+    auto caller = std::this_thread::get_id();
+    std::atomic<bool> workerCounted = false;
+    std::vector<int> values(10000);
+    ++counters.local().count;
+    threading.for_each(values.begin(), values.end(), [&](int)
+        {
+            // The caller runs the first chunk, holding it until a worker counted too.
+            if (std::this_thread::get_id() == caller)
+            {
+                while (not workerCounted)
+                    std::this_thread::yield();
+            }
+            ++counters.local().count;
+            if (std::this_thread::get_id() != caller)
+                workerCounted = true;
+        });
+    ++counters.local().count;
+
+    std::vector<std::thread::id> owners;
+    std::size_t callerCount = 0;
+    counters.combineEach([&](const Counter &counter)
+        {
+            owners.push_back(counter.owner);
+            if (counter.owner == caller)
+                callerCount = counter.count;
+        });
+    ASSERT_EQ(std::count(owners.begin(), owners.end(), caller), 1);
+    ASSERT_GE(owners.size(), 2);
+    std::sort(owners.begin(), owners.end());
+    ASSERT_EQ(std::adjacent_find(owners.begin(), owners.end()), owners.end());
+    ASSERT_GE(callerCount, 2);
+    ASSERT_EQ(counters.combine([](Counter lhs, const Counter &rhs) { lhs.count += rhs.count; return lhs; }).count, values.size() + 2);
+}
+
+TEST(pipeline, fusesStagesInOnePass)
+{
+    s0m4b0dY::ThreadPool pool(3);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(128));
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    std::atomic<int> squared = 0;
+    std::atomic<int> tested = 0;
+    auto oddSquares = s0m4b0dY::pipeline(threading, values)
+        .transform([&squared](int value) { ++squared; return static_cast<long long>(value) * value; })
+        .filter([&tested](long long square) { ++tested; return square % 2 != 0; });
+    long long expected = 0;
+    for (long long value : values)
+        expected += value % 2 != 0 ? value * value : 0;
+    ASSERT_EQ(oddSquares.reduce(0LL), expected);
+    // Every stage saw every element exactly once, nothing was walked twice.
+    ASSERT_EQ(squared, 10000);
+    ASSERT_EQ(tested, 10000);
+    ASSERT_EQ(oddSquares.count(), 5000);
+    std::atomic<long long> visited = 0;
+    oddSquares.for_each([&visited](long long square) { visited += square; });
+    ASSERT_EQ(visited, expected);
+    ASSERT_EQ(oddSquares.filter([](long long) { return false; }).reduce(7LL), 7);
+}
+
+TEST(pipeline, acceptsRandomAccessViews)
+{
+    s0m4b0dY::ThreadPool pool(2);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(100));
+    auto halves = std::views::iota(0, 1000) | std::views::transform([](int value) { return value / 2.0; });
+    auto sum = s0m4b0dY::pipeline(threading, halves)
+        .filter([](double half) { return half >= 250; })
+        .reduce(0.0);
+    ASSERT_DOUBLE_EQ(sum, 187375.0);
+    ASSERT_EQ(s0m4b0dY::pipeline(threading, std::views::iota(0, 0)).count(), 0);
+    auto maximum = s0m4b0dY::pipeline(threading, std::views::iota(-50, 50))
+        .transform([](int value) { return value * value; })
+        .reduce(0, [](int lhs, int rhs) { return std::max(lhs, rhs); });
+    ASSERT_EQ(maximum, 2500);
+}
+
+TEST(pipeline, keepsTemporaryRangesAlive)
+{
+    s0m4b0dY::ThreadPool pool(2);
+    s0m4b0dY::Threading threading(pool, s0m4b0dY::Partitioner::fixedGrain(100));
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    // Both temporaries are gone before the terminal operation runs.
+    auto owning = s0m4b0dY::pipeline(threading, std::vector<int>(values)).filter([](int value) { return value % 2 == 0; });
+    auto transformed = s0m4b0dY::pipeline(threading, values | std::views::transform([](int value) { return value * 3; }));
+    ASSERT_EQ(owning.count(), 500);
+    ASSERT_EQ(owning.transform([](int value) { return static_cast<long long>(value); }).reduce(0LL), 249500);
+    ASSERT_EQ(transformed.reduce(0LL), 1498500);
+}
+
 class SortPerformanceTest : public ::testing::Test {
 protected:
     void SetUp() override {
         // Initialize random data
-        for (int i = 0; i < testDataSize; ++i) {
+        for (std::size_t i = 0; i < testDataSize; ++i) {
             data.push_back(rand() % 10000);
         }
     }
@@ -224,3 +1181,425 @@ TEST_F(SortPerformanceTest, OddEvenSortPerformance) {
     // Check if sorted
     ASSERT_TRUE(std::is_sorted(dataCopy.begin(), dataCopy.end()));
 }
+
+TEST(threadingPool, borrowedPoolIsUsed)
+{
+    s0m4b0dY::ThreadPool pool(3);
+    s0m4b0dY::Threading threading(pool);
+    ASSERT_EQ(&threading.pool(), &pool);
+    auto range = std::ranges::views::iota(0, 500);
+    std::vector<int> arr(range.begin(), range.end());
+    ASSERT_EQ(threading.reduce(arr.begin(), arr.end()), std::reduce(arr.begin(), arr.end()));
+}
+
+TEST(partitioner, chunksCoverRangeInOrder)
+{
+    using s0m4b0dY::Partitioner;
+    for (auto partitioner : {Partitioner::staticPartition(), Partitioner::fixedGrain(100), Partitioner::guided(10), Partitioner::automatic(0, 4, 10)})
+    {
+        for (std::size_t size : {0, 1, 7, 999, 100000})
+        {
+            auto chunks = partitioner.split(size, 4);
+            std::size_t expectedFirst = 0;
+            for (auto [first, last] : chunks)
+            {
+                ASSERT_EQ(first, expectedFirst);
+                ASSERT_LT(first, last);
+                expectedFirst = last;
+            }
+            ASSERT_EQ(expectedFirst, size);
+        }
+    }
+}
+
+TEST(partitioner, policiesShapeChunks)
+{
+    using s0m4b0dY::Partitioner;
+    ASSERT_EQ(Partitioner::staticPartition().split(1000, 4).size(), 4);
+    ASSERT_EQ(Partitioner::fixedGrain(100).split(1001, 4).size(), 11);
+    auto guided = Partitioner::guided(10).split(1000, 4);
+    ASSERT_EQ(guided.front().second - guided.front().first, 250);
+    ASSERT_LE(guided.back().second - guided.back().first, 10);
+    ASSERT_EQ(Partitioner().split(500, 4).size(), 1);
+    ASSERT_EQ(Partitioner::automatic(100, 4, 10).split(100000, 4).size(), 16);
+    ASSERT_EQ(Partitioner::automatic(100, 4, 1000).split(5000, 4).size(), 5);
+}
+
+TEST(threadingPool, withPartitionerSharesPool)
+{
+    s0m4b0dY::ThreadPool pool(3);
+    s0m4b0dY::Threading threading(pool);
+    auto tuned = threading.with(s0m4b0dY::Partitioner::fixedGrain(7));
+    ASSERT_EQ(&tuned.pool(), &pool);
+    ASSERT_EQ(tuned.partitioner().kind(), s0m4b0dY::Partitioner::Kind::FixedGrain);
+    ASSERT_EQ(threading.partitioner().kind(), s0m4b0dY::Partitioner::Kind::Auto);
+    auto range = std::ranges::views::iota(0, 500);
+    std::vector<int> arr(range.begin(), range.end());
+    ASSERT_EQ(tuned.reduce(arr.begin(), arr.end()), std::reduce(arr.begin(), arr.end()));
+}
+
+TEST(threadingPool, defaultConstructedSharesDefaultPool)
+{
+    s0m4b0dY::Threading first;
+    s0m4b0dY::Threading second;
+    ASSERT_EQ(&first.pool(), &second.pool());
+    ASSERT_EQ(&first.pool(), &s0m4b0dY::ThreadPool::defaultPool());
+}
+
+TEST_F(SortPerformanceTest, ParallelStdSortPerformance) {
+    std::vector<int> dataCopy = data;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::sort(std::execution::par_unseq, dataCopy.begin(), dataCopy.end());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "std::sort(par_unseq) time: " << duration << " ms" << std::endl;
+
+    // Check if sorted
+    ASSERT_TRUE(std::is_sorted(dataCopy.begin(), dataCopy.end()));
+}
+
+TEST_F(SortPerformanceTest, ThreadingSortPerformance) {
+    std::vector<int> dataCopy = data;
+
+    s0m4b0dY::Threading threading;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    threading.sort(dataCopy.begin(), dataCopy.end());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Threading sort time: " << duration << " ms" << std::endl;
+
+    // Check if sorted
+    ASSERT_TRUE(std::is_sorted(dataCopy.begin(), dataCopy.end()));
+}
+
+TEST_F(SortPerformanceTest, ThreadingStableSortPerformance) {
+    std::vector<int> dataCopy = data;
+
+    s0m4b0dY::Threading threading;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    threading.stable_sort(dataCopy.begin(), dataCopy.end());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Threading stable sort time: " << duration << " ms" << std::endl;
+
+    // Check if sorted
+    ASSERT_TRUE(std::is_sorted(dataCopy.begin(), dataCopy.end()));
+}
+
+TEST_F(SortPerformanceTest, RadixSortPerformance) {
+    std::vector<std::uint32_t> keys(1 << 24);
+    std::uint64_t state = 1;
+    for (auto &key : keys) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        key = static_cast<std::uint32_t>(state >> 32);
+    }
+    s0m4b0dY::Threading threading;
+    auto measure = [&keys](const char *name, auto &&sort) {
+        auto dataCopy = keys;
+        auto start = std::chrono::high_resolution_clock::now();
+        sort(dataCopy);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " ms" << std::endl;
+        ASSERT_TRUE(std::is_sorted(dataCopy.begin(), dataCopy.end()));
+    };
+
+    measure("std::sort(par_unseq) uint32", [](auto &values) { std::sort(std::execution::par_unseq, values.begin(), values.end()); });
+    measure("Threading sort uint32", [&threading](auto &values) { threading.sort(values.begin(), values.end()); });
+    measure("Threading radix sort uint32", [&threading](auto &values) { threading.radix_sort(values.begin(), values.end()); });
+}
+
+class ReducePerformanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (std::size_t i = 0; i < testDataSize; ++i) {
+            ints.push_back(rand() % 10000);
+            floats.push_back(static_cast<float>(rand() % 10000) / 100);
+        }
+    }
+
+    static constexpr size_t testDataSize = 1<<24;
+    std::vector<int> ints;
+    std::vector<float> floats;
+};
+
+TEST_F(ReducePerformanceTest, FusedPipelinePerformance) {
+    s0m4b0dY::Threading threading;
+    auto measure = [](const char *name, auto &&function) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto result = function();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " us (" << result << ")" << std::endl;
+    };
+    auto scale = [](int value) { return value * 3 + 1; };
+    auto isEven = [](int value) { return value % 2 == 0; };
+
+    measure("Threading transform then count_if", [&]() {
+        std::vector<int> scaled(ints.size());
+        threading.transform(ints.begin(), ints.end(), scaled.begin(), scale);
+        return threading.count_if(scaled.begin(), scaled.end(), isEven);
+    });
+    measure("Fused pipeline transform filter count", [&]() {
+        return s0m4b0dY::pipeline(threading, ints).transform(scale).filter(isEven).count();
+    });
+}
+
+TEST_F(ReducePerformanceTest, HistogramPerformance) {
+    s0m4b0dY::Threading threading;
+    constexpr std::size_t binCount = 16;
+    auto key = [](int value) { return static_cast<std::size_t>(value) * binCount / 10000; };
+    auto measure = [](const char *name, auto &&function) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto result = function();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " us (" << result << ")" << std::endl;
+    };
+
+    measure("count_if per bin", [&]() {
+        std::size_t first = 0;
+        for (std::size_t bin = 0; bin < binCount; ++bin)
+        {
+            auto count = threading.count_if(ints.begin(), ints.end(), [&key, bin](int value) { return key(value) == bin; });
+            first = bin == 0 ? count : first;
+        }
+        return first;
+    });
+    measure("Shared atomic bins", [&]() {
+        std::array<std::atomic<std::size_t>, binCount> bins{};
+        threading.for_each(ints.begin(), ints.end(), [&bins, &key](int value) { bins[key(value)].fetch_add(1, std::memory_order_relaxed); });
+        return bins[0].load();
+    });
+    measure("Threading histogram", [&]() {
+        return threading.histogram(ints.begin(), ints.end(), binCount, key)[0];
+    });
+}
+
+TEST_F(ReducePerformanceTest, SumPerformance) {
+    s0m4b0dY::Threading threading;
+    auto measure = [](const char *name, auto &&function) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto result = function();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " us (" << result << ")" << std::endl;
+    };
+
+    measure("std::reduce int", [&]() { return std::reduce(ints.begin(), ints.end()); });
+    measure("Threading reduce int", [&]() { return threading.reduce(ints.begin(), ints.end()); });
+    measure("std::accumulate float", [&]() { return std::accumulate(floats.begin(), floats.end(), 0.0f); });
+    measure("Threading reduce float ordered", [&]() { return threading.reduce(floats.begin(), floats.end()); });
+    measure("Threading reduce float reassociate", [&]() { return threading.reduce(floats.begin(), floats.end(), s0m4b0dY::FloatSummation::Reassociate); });
+    measure("Threading reduce float pairwise", [&]() { return threading.reduce(floats.begin(), floats.end(), s0m4b0dY::FloatSummation::Pairwise); });
+}
+
+class ScanPerformanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (std::size_t i = 0; i < testDataSize; ++i) {
+            data.push_back(rand() % 10000);
+        }
+        output.resize(testDataSize);
+    }
+
+    static constexpr size_t testDataSize = 1<<24;
+    std::vector<long long> data;
+    std::vector<long long> output;
+};
+
+TEST_F(ScanPerformanceTest, SequentialInclusiveScanPerformance) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::inclusive_scan(data.begin(), data.end(), output.begin());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "std::inclusive_scan time: " << duration << " ms" << std::endl;
+}
+
+TEST_F(ScanPerformanceTest, ParallelStdInclusiveScanPerformance) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::inclusive_scan(std::execution::par, data.begin(), data.end(), output.begin());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "std::inclusive_scan(par) time: " << duration << " ms" << std::endl;
+}
+
+TEST_F(ScanPerformanceTest, ThreadingInclusiveScanPerformance) {
+    s0m4b0dY::Threading threading;
+    auto start = std::chrono::high_resolution_clock::now();
+    threading.inclusive_scan(data.begin(), data.end(), output.begin());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Threading inclusive_scan time: " << duration << " ms" << std::endl;
+    ASSERT_EQ(output.back(), std::reduce(data.begin(), data.end()));
+}
+
+TEST_F(ScanPerformanceTest, ThreadingExclusiveScanPerformance) {
+    s0m4b0dY::Threading threading;
+    auto start = std::chrono::high_resolution_clock::now();
+    threading.exclusive_scan(data.begin(), data.end(), output.begin(), 0ll);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Threading exclusive_scan time: " << duration << " ms" << std::endl;
+    ASSERT_EQ(output.back() + data.back(), std::reduce(data.begin(), data.end()));
+}
+
+class CompactionPerformanceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (std::size_t i = 0; i < testDataSize; ++i) {
+            data.push_back(rand() % 10000);
+        }
+        output.resize(testDataSize);
+    }
+
+    static constexpr size_t testDataSize = 1<<24;
+    std::vector<int> data;
+    std::vector<int> output;
+    static bool isSelected(int value) { return value % 3 == 0; }
+};
+
+TEST_F(CompactionPerformanceTest, CopyIfPerformance) {
+    s0m4b0dY::Threading threading;
+    auto measure = [](const char *name, auto &&function) {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " ms" << std::endl;
+    };
+
+    measure("std::copy_if", [&]() { std::copy_if(data.begin(), data.end(), output.begin(), isSelected); });
+    measure("std::copy_if(par)", [&]() { std::copy_if(std::execution::par, data.begin(), data.end(), output.begin(), isSelected); });
+    measure("Threading copy_if", [&]() { threading.copy_if(data.begin(), data.end(), output.begin(), isSelected); });
+    measure("std::partition", [&]() { auto copy = data; std::partition(copy.begin(), copy.end(), isSelected); });
+    measure("Threading partition", [&]() { auto copy = data; threading.partition(copy.begin(), copy.end(), isSelected); });
+    measure("Threading stable_partition", [&]() { auto copy = data; threading.stable_partition(copy.begin(), copy.end(), isSelected); });
+}
+
+class TiledPerformanceTest : public ::testing::Test {
+protected:
+    static constexpr std::size_t matrixSize = 512;
+    static constexpr std::size_t gridSize = 4096;
+    static constexpr std::size_t tileSize = 64;
+
+    template <class Function>
+    static void measure(const char *name, Function &&function) {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << name << " time: " << duration << " ms" << std::endl;
+    }
+};
+
+TEST_F(TiledPerformanceTest, MatrixMultiplyPerformance) {
+    std::vector<double> lhs(matrixSize * matrixSize), rhs(matrixSize * matrixSize);
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        lhs[i] = static_cast<double>(rand() % 100) / 10;
+        rhs[i] = static_cast<double>(rand() % 100) / 10;
+    }
+    std::vector<double> rowsResult(matrixSize * matrixSize);
+    s0m4b0dY::Threading threading;
+
+    // Every row streams the whole right hand side matrix.
+    measure("Row parallel matrix multiply", [&]() {
+        threading.parallel_for(std::size_t(0), matrixSize, std::size_t(1), [&](s0m4b0dY::BlockedRange<std::size_t> rows) {
+            for (auto i = rows.begin(); i != rows.end(); ++i)
+                for (std::size_t j = 0; j < matrixSize; ++j) {
+                    double sum = 0;
+                    for (std::size_t k = 0; k < matrixSize; ++k)
+                        sum += lhs[i * matrixSize + k] * rhs[k * matrixSize + j];
+                    rowsResult[i * matrixSize + j] = sum;
+                }
+        });
+    });
+
+    for (auto [name, order] : {std::pair{"Tiled row major matrix multiply", s0m4b0dY::TileOrder::RowMajor},
+                               std::pair{"Tiled Morton matrix multiply", s0m4b0dY::TileOrder::Morton},
+                               std::pair{"Tiled Hilbert matrix multiply", s0m4b0dY::TileOrder::Hilbert}}) {
+        std::vector<double> tiledResult(matrixSize * matrixSize);
+        measure(name, [&]() {
+            s0m4b0dY::BlockedRange2d<std::size_t> range({0, matrixSize}, {0, matrixSize});
+            threading.parallel_for(range, tileSize, tileSize, [&](s0m4b0dY::BlockedRange2d<std::size_t> tile) {
+                // The k loop is blocked as well, so the tiles of both inputs stay in cache.
+                for (std::size_t kk = 0; kk < matrixSize; kk += tileSize)
+                    for (auto i = tile.rows().begin(); i != tile.rows().end(); ++i)
+                        for (std::size_t k = kk; k < std::min(kk + tileSize, matrixSize); ++k) {
+                            double value = lhs[i * matrixSize + k];
+                            for (auto j = tile.cols().begin(); j != tile.cols().end(); ++j)
+                                tiledResult[i * matrixSize + j] += value * rhs[k * matrixSize + j];
+                        }
+            }, order);
+        });
+        for (std::size_t i = 0; i < tiledResult.size(); ++i)
+            ASSERT_NEAR(tiledResult[i], rowsResult[i], 1e-6 * std::abs(rowsResult[i]) + 1e-9);
+    }
+}
+
+TEST_F(TiledPerformanceTest, StencilPerformance) {
+    std::vector<float> grid(gridSize * gridSize), rowsResult(gridSize * gridSize), tiledResult(gridSize * gridSize);
+    for (auto &value : grid)
+        value = static_cast<float>(rand() % 1000);
+    s0m4b0dY::Threading threading;
+    auto stencil = [&grid](std::vector<float> &output, std::size_t row, std::size_t col) {
+        output[row * gridSize + col] = 0.2f * (grid[row * gridSize + col] + grid[(row - 1) * gridSize + col] + grid[(row + 1) * gridSize + col]
+                                               + grid[row * gridSize + col - 1] + grid[row * gridSize + col + 1]);
+    };
+
+    measure("Row parallel 5-point stencil", [&]() {
+        threading.parallel_for(std::size_t(1), gridSize - 1, [&](s0m4b0dY::BlockedRange<std::size_t> rows) {
+            for (auto row = rows.begin(); row != rows.end(); ++row)
+                for (std::size_t col = 1; col < gridSize - 1; ++col)
+                    stencil(rowsResult, row, col);
+        });
+    });
+    measure("Tiled Hilbert 5-point stencil", [&]() {
+        s0m4b0dY::BlockedRange2d<std::size_t> range({1, gridSize - 1}, {1, gridSize - 1});
+        threading.parallel_for(range, 256, 256, [&](s0m4b0dY::BlockedRange2d<std::size_t> tile) {
+            for (auto row = tile.rows().begin(); row != tile.rows().end(); ++row)
+                for (auto col = tile.cols().begin(); col != tile.cols().end(); ++col)
+                    stencil(tiledResult, row, col);
+        }, s0m4b0dY::TileOrder::Hilbert);
+    });
+    ASSERT_EQ(rowsResult, tiledResult);
+}
+
+class PriorityPerformanceTest : public ::testing::Test {
+protected:
+    // Latency of a small find_if while a bulk for_each keeps every worker busy in the background.
+    static double findLatency(s0m4b0dY::ThreadPool::Priority background, s0m4b0dY::ThreadPool::Priority foreground) {
+        s0m4b0dY::Threading threading(s0m4b0dY::ThreadPool::defaultPool(), s0m4b0dY::Partitioner::fixedGrain(1 << 12));
+        std::vector<double> bulk(1 << 22, 1.0);
+        std::vector<int> needles(1 << 16);
+        std::iota(needles.begin(), needles.end(), 0);
+        std::atomic_bool stop = false;
+        std::thread batch([&]() {
+            while (not stop)
+                threading.with(background).for_each(bulk.begin(), bulk.end(), [](double &value) { value = std::sqrt(value + 1.0); });
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        constexpr int rounds = 20;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto round = 0; round < rounds; ++round) {
+            auto found = threading.with(foreground).find(needles.begin(), needles.end(), int(needles.size()) - 1);
+            EXPECT_EQ(found, std::prev(needles.end()));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        stop = true;
+        batch.join();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / double(rounds);
+    }
+};
+
+TEST_F(PriorityPerformanceTest, InteractiveFindUnderBatchLoad) {
+    using Priority = s0m4b0dY::ThreadPool::Priority;
+    std::cout << "find under normal priority batch, same priority time: " << findLatency(Priority::Normal, Priority::Normal) << " us" << std::endl;
+    std::cout << "find under low priority batch, high priority time: " << findLatency(Priority::Low, Priority::High) << " us" << std::endl;
+}
@@ -0,0 +1,329 @@
+#ifndef S0_ASYNC_HPP
+#define S0_ASYNC_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief What co_await on an Async<T> yields, with std::monostate standing in for void where a value is needed.
+     */
+    template <class T>
+    using AsyncValue_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    /**
+     * @brief Result slot shared by an Async and whoever produces the result.
+     * The producer calls setValue() or setException() once, then complete().
+     */
+    template <class T>
+    class AsyncState
+    {
+    public:
+        template <class... Args>
+        void setValue(Args &&...args);
+        void setException(std::exception_ptr exception) noexcept;
+
+        /**
+         * @brief Publishes the result. A coroutine already waiting for it is resumed on this thread.
+         */
+        void complete() noexcept;
+
+        bool ready() const noexcept;
+
+        /**
+         * @brief Blocks until complete().
+         */
+        void wait() const noexcept;
+
+        /**
+         * @brief Registers @p continuation to be resumed by complete().
+         * @return false if the result is already there, then nobody resumes @p continuation.
+         */
+        bool suspend(std::coroutine_handle<> continuation) noexcept;
+
+        /**
+         * @brief Moves the value out or rethrows the exception. Only valid once, after complete().
+         */
+        T take();
+
+    private:
+        enum Phase : unsigned char
+        {
+            Pending,
+            Awaited,
+            Done
+        };
+
+        std::atomic<unsigned char> phase_ = Pending;
+        std::coroutine_handle<> continuation_;
+        std::optional<AsyncValue_t<T>> value_;
+        std::exception_ptr exception_;
+    };
+
+    template <class T>
+    class Async;
+
+    /**
+     * @brief return_value() or return_void() of Async<T>::promise_type, a promise may only have one of them.
+     */
+    template <class T>
+    struct AsyncPromiseBase
+    {
+        template <class U = T>
+        void return_value(U &&value)
+        {
+            state->setValue(std::forward<U>(value));
+        }
+
+        std::shared_ptr<AsyncState<T>> state = std::make_shared<AsyncState<T>>();
+    };
+
+    template <>
+    struct AsyncPromiseBase<void>
+    {
+        void return_void()
+        {
+            state->setValue();
+        }
+
+        std::shared_ptr<AsyncState<void>> state = std::make_shared<AsyncState<void>>();
+    };
+
+    /**
+     * @brief Result of an asynchronous computation, awaitable from a coroutine.
+     * The computation starts right away. co_await suspends the coroutine without blocking the thread,
+     * the thread that finishes the computation resumes it. Every Async can be awaited (or get()) once.
+     *
+     * Async<T> is a coroutine return type too. Such a coroutine runs on the caller until its first
+     * suspending co_await and returns an Async that completes with its co_return.
+     */
+    template <class T>
+    class [[nodiscard]] Async
+    {
+    public:
+        struct promise_type;
+
+        struct Settled
+        {
+            bool await_ready() const noexcept { return state->ready(); }
+            bool await_suspend(std::coroutine_handle<> continuation) noexcept { return state->suspend(continuation); }
+            void await_resume() const noexcept { }
+
+            AsyncState<T> *state;
+        };
+
+        explicit Async(std::shared_ptr<AsyncState<T>> state) noexcept;
+
+        /**
+         * @brief An Async that is ready with @p args... as its value.
+         */
+        template <class... Args>
+        static Async fromValue(Args &&...args);
+
+        bool ready() const noexcept;
+
+        /**
+         * @brief Blocks the calling thread until the result is there.
+         * @note Blocking a pool worker on an Async its own pool has to finish can deadlock a small pool.
+         */
+        T get();
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> continuation) noexcept;
+        T await_resume();
+
+        /**
+         * @brief Awaitable that waits for the result without taking it, so one failure does not skip the other awaits.
+         */
+        Settled settled() noexcept;
+
+        /**
+         * @brief Like await_resume(), std::monostate for Async<void>.
+         */
+        AsyncValue_t<T> takeValue();
+
+    private:
+        std::shared_ptr<AsyncState<T>> state_;
+    };
+
+    template <class T>
+    struct Async<T>::promise_type : AsyncPromiseBase<T>
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<promise_type> coroutine) const noexcept
+            {
+                // The frame goes first, completing may resume a continuation that runs for a long time.
+                auto state = std::move(coroutine.promise().state);
+                coroutine.destroy();
+                state->complete();
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        Async get_return_object() { return Async(this->state); }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() noexcept { this->state->setException(std::current_exception()); }
+    };
+
+    /**
+     * @brief Waits for every Async, then yields their values in argument order.
+     * The first exception in argument order is rethrown once all of them finished.
+     */
+    template <class... T>
+    Async<std::tuple<AsyncValue_t<T>...>> when_all(Async<T>... asyncs);
+
+    template <class T>
+    Async<std::vector<AsyncValue_t<T>>> when_all(std::vector<Async<T>> asyncs);
+
+    template <class T>
+    template <class... Args>
+    inline void AsyncState<T>::setValue(Args &&...args)
+    {
+        value_.emplace(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    inline void AsyncState<T>::setException(std::exception_ptr exception) noexcept
+    {
+        exception_ = std::move(exception);
+    }
+
+    template <class T>
+    inline void AsyncState<T>::complete() noexcept
+    {
+        auto previous = phase_.exchange(Done, std::memory_order_acq_rel);
+        phase_.notify_all();
+        if (previous == Awaited)
+            continuation_.resume();
+    }
+
+    template <class T>
+    inline bool AsyncState<T>::ready() const noexcept
+    {
+        return phase_.load(std::memory_order_acquire) == Done;
+    }
+
+    template <class T>
+    inline void AsyncState<T>::wait() const noexcept
+    {
+        for (auto phase = phase_.load(std::memory_order_acquire); phase != Done; phase = phase_.load(std::memory_order_acquire))
+            phase_.wait(phase, std::memory_order_acquire);
+    }
+
+    template <class T>
+    inline bool AsyncState<T>::suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        continuation_ = continuation;
+        unsigned char expected = Pending;
+        return phase_.compare_exchange_strong(expected, Awaited, std::memory_order_acq_rel);
+    }
+
+    template <class T>
+    inline T AsyncState<T>::take()
+    {
+        if (exception_)
+            std::rethrow_exception(exception_);
+        if constexpr (not std::is_void_v<T>)
+            return std::move(value_).value();
+    }
+
+    template <class T>
+    inline Async<T>::Async(std::shared_ptr<AsyncState<T>> state) noexcept
+        : state_(std::move(state))
+    { }
+
+    template <class T>
+    template <class... Args>
+    inline Async<T> Async<T>::fromValue(Args &&...args)
+    {
+        auto state = std::make_shared<AsyncState<T>>();
+        state->setValue(std::forward<Args>(args)...);
+        state->complete();
+        return Async(std::move(state));
+    }
+
+    template <class T>
+    inline bool Async<T>::ready() const noexcept
+    {
+        return state_->ready();
+    }
+
+    template <class T>
+    inline T Async<T>::get()
+    {
+        state_->wait();
+        return state_->take();
+    }
+
+    template <class T>
+    inline bool Async<T>::await_ready() const noexcept
+    {
+        return state_->ready();
+    }
+
+    template <class T>
+    inline bool Async<T>::await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        return state_->suspend(continuation);
+    }
+
+    template <class T>
+    inline T Async<T>::await_resume()
+    {
+        return state_->take();
+    }
+
+    template <class T>
+    inline typename Async<T>::Settled Async<T>::settled() noexcept
+    {
+        return Settled{state_.get()};
+    }
+
+    template <class T>
+    inline AsyncValue_t<T> Async<T>::takeValue()
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            state_->take();
+            return {};
+        }
+        else
+            return state_->take();
+    }
+
+    template <class... T>
+    inline Async<std::tuple<AsyncValue_t<T>...>> when_all(Async<T>... asyncs)
+    {
+        // co_await only waits here, the values are taken afterwards.
+        ((co_await asyncs.settled(), void()), ...);
+        co_return std::tuple<AsyncValue_t<T>...>{asyncs.takeValue()...};
+    }
+
+    template <class T>
+    inline Async<std::vector<AsyncValue_t<T>>> when_all(std::vector<Async<T>> asyncs)
+    {
+        for (auto &async : asyncs)
+            co_await async.settled();
+        std::vector<AsyncValue_t<T>> values;
+        values.reserve(asyncs.size());
+        for (auto &async : asyncs)
+            values.push_back(async.takeValue());
+        co_return values;
+    }
+}
+
+#endif
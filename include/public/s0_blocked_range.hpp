@@ -0,0 +1,141 @@
+#ifndef S0_BLOCKED_RANGE_HPP
+#define S0_BLOCKED_RANGE_HPP
+
+#include <cstddef>
+#include <concepts>
+#include <span>
+#include <vector>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief Half open index range [begin, end) handed to parallel_for bodies.
+     */
+    template < std::integral Index_t = std::size_t >
+    class BlockedRange
+    {
+    public:
+        using index_type = Index_t;
+
+        constexpr BlockedRange(Index_t begin, Index_t end) noexcept
+            : begin_(begin),
+              end_(end)
+        { }
+
+        constexpr Index_t begin() const noexcept
+        {
+            return begin_;
+        }
+
+        constexpr Index_t end() const noexcept
+        {
+            return end_;
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return end_ > begin_ ? static_cast<std::size_t>(end_ - begin_) : 0;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return not (begin_ < end_);
+        }
+
+    private:
+        Index_t begin_;
+        Index_t end_;
+    };
+
+    template < std::integral Index_t = std::size_t >
+    class BlockedRange2d
+    {
+    public:
+        using index_type = Index_t;
+
+        constexpr BlockedRange2d(BlockedRange<Index_t> rows, BlockedRange<Index_t> cols) noexcept
+            : rows_(rows),
+              cols_(cols)
+        { }
+
+        constexpr BlockedRange<Index_t> rows() const noexcept
+        {
+            return rows_;
+        }
+
+        constexpr BlockedRange<Index_t> cols() const noexcept
+        {
+            return cols_;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return rows_.empty() or cols_.empty();
+        }
+
+    private:
+        BlockedRange<Index_t> rows_;
+        BlockedRange<Index_t> cols_;
+    };
+
+    template < std::integral Index_t = std::size_t >
+    class BlockedRange3d
+    {
+    public:
+        using index_type = Index_t;
+
+        constexpr BlockedRange3d(BlockedRange<Index_t> pages, BlockedRange<Index_t> rows, BlockedRange<Index_t> cols) noexcept
+            : pages_(pages),
+              rows_(rows),
+              cols_(cols)
+        { }
+
+        constexpr BlockedRange<Index_t> pages() const noexcept
+        {
+            return pages_;
+        }
+
+        constexpr BlockedRange<Index_t> rows() const noexcept
+        {
+            return rows_;
+        }
+
+        constexpr BlockedRange<Index_t> cols() const noexcept
+        {
+            return cols_;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return pages_.empty() or rows_.empty() or cols_.empty();
+        }
+
+    private:
+        BlockedRange<Index_t> pages_;
+        BlockedRange<Index_t> rows_;
+        BlockedRange<Index_t> cols_;
+    };
+
+    /**
+     * @brief Order in which the tiles of a multidimensional parallel_for are handed out.
+     * Consecutive tiles along Morton and Hilbert curves are close in every dimension, so a worker taking a run
+     * of them reuses the neighbouring rows and columns it already has in cache.
+     */
+    enum class TileOrder
+    {
+        RowMajor,
+        Morton,
+        /**
+         * @brief Like Morton without the long jumps, consecutive tiles always share a face on power of 2 grids.
+         */
+        Hilbert
+    };
+
+    /**
+     * @brief Row major indices of the tiles of a grid with @p tileCounts tiles per dimension, in visiting order.
+     * The last dimension is the fastest changing one.
+     */
+    std::vector<std::size_t> tileSequence(std::span<const std::size_t> tileCounts, TileOrder order);
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef S0_COMBINABLE_HPP
+#define S0_COMBINABLE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "s0_thread_pool.hpp"
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief One T per thread working for a ThreadPool, combined once the parallel part is done.
+     * Every pool worker owns a cache line aligned slot, so local() needs neither atomics nor locks on a worker.
+     * Threads outside the pool, e.g. the caller running the first chunk of a Threading algorithm,
+     * get their own slot after a lookup under a mutex.
+     * @note local() may be called concurrently, combine(), combineEach() and clear() may not.
+     */
+    template <class T>
+    class Combinable
+    {
+    public:
+        /**
+         * @brief Slots start out as T().
+         */
+        explicit Combinable(ThreadPool &pool = ThreadPool::defaultPool());
+
+        /**
+         * @brief Slots start out as initializer().
+         */
+        template <class Initializer>
+        Combinable(ThreadPool &pool, Initializer initializer);
+
+        Combinable(const Combinable &) = delete;
+        Combinable &operator=(const Combinable &) = delete;
+
+        /**
+         * @return Slot of the calling thread, created on first use.
+         */
+        T &local();
+
+        /**
+         * @param exists Set to whether the slot was used before.
+         */
+        T &local(bool &exists);
+
+        /**
+         * @brief Folds the used slots with @p binaryOperation, worker slots first in worker order, then the outside threads.
+         * @return The initial value if no slot was used.
+         */
+        template <class BinaryOperation>
+        T combine(BinaryOperation binaryOperation) const;
+
+        /**
+         * @brief Calls function(slot) for every used slot.
+         */
+        template <class Function>
+        void combineEach(Function &&function) const;
+
+        /**
+         * @brief Drops every slot, the next local() starts over from the initial value.
+         */
+        void clear();
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::optional<T> value;
+        };
+
+        T &use(Slot &slot, bool &exists);
+
+        ThreadPool &pool_;
+        std::function<T()> initializer_;
+        std::unique_ptr<Slot[]> workerSlots_;
+        std::mutex outsidersMutex_;
+        // Deque, so slots handed out stay where they are while other threads add theirs.
+        std::deque<std::pair<std::thread::id, Slot>> outsiders_;
+    };
+
+    template <class T>
+    inline Combinable<T>::Combinable(ThreadPool &pool)
+        : Combinable(pool, []() { return T(); })
+    { }
+
+    template <class T>
+    template <class Initializer>
+    inline Combinable<T>::Combinable(ThreadPool &pool, Initializer initializer)
+        : pool_(pool),
+          initializer_(std::move(initializer)),
+          workerSlots_(std::make_unique<Slot[]>(pool.maxSize()))
+    { }
+
+    template <class T>
+    inline T &Combinable<T>::local()
+    {
+        bool exists;
+        return local(exists);
+    }
+
+    template <class T>
+    inline T &Combinable<T>::local(bool &exists)
+    {
+        auto slot = pool_.currentSlot();
+        if (slot < pool_.maxSize())
+            return use(workerSlots_[slot], exists);
+        std::lock_guard<std::mutex> lock(outsidersMutex_);
+        auto id = std::this_thread::get_id();
+        for (auto &[thread, outsider] : outsiders_)
+        {
+            if (thread == id)
+                return use(outsider, exists);
+        }
+        return use(outsiders_.emplace_back(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple()).second, exists);
+    }
+
+    template <class T>
+    inline T &Combinable<T>::use(Slot &slot, bool &exists)
+    {
+        exists = slot.value.has_value();
+        if (not exists)
+            slot.value.emplace(initializer_());
+        return *slot.value;
+    }
+
+    template <class T>
+    template <class BinaryOperation>
+    inline T Combinable<T>::combine(BinaryOperation binaryOperation) const
+    {
+        std::optional<T> result;
+        combineEach([&result, &binaryOperation](const T &value)
+            {
+                if (result.has_value())
+                    result.emplace(binaryOperation(std::move(result).value(), value));
+                else
+                    result.emplace(value);
+            });
+        if (result.has_value())
+            return std::move(result).value();
+        return initializer_();
+    }
+
+    template <class T>
+    template <class Function>
+    inline void Combinable<T>::combineEach(Function &&function) const
+    {
+        for (std::size_t slot = 0; slot < pool_.maxSize(); ++slot)
+        {
+            if (workerSlots_[slot].value.has_value())
+                function(*workerSlots_[slot].value);
+        }
+        for (const auto &[thread, outsider] : outsiders_)
+        {
+            if (outsider.value.has_value())
+                function(*outsider.value);
+        }
+    }
+
+    template <class T>
+    inline void Combinable<T>::clear()
+    {
+        for (std::size_t slot = 0; slot < pool_.maxSize(); ++slot)
+            workerSlots_[slot].value.reset();
+        outsiders_.clear();
+    }
+}
+
+#endif
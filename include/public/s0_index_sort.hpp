@@ -0,0 +1,164 @@
+#ifndef S0_INDEX_SORT_HPP
+#define S0_INDEX_SORT_HPP
+
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+
+namespace s0m4b0dY
+{
+    enum class SortStability
+    {
+        Unstable,
+        /**
+         * @brief Equal elements keep their relative order. Ties are broken by the original position.
+         */
+        Stable
+    };
+
+    /**
+     * @brief Sort engine that permutes a contiguous array of entries instead of the elements themselves.
+     * Small trivially copyable elements are copied into (key, index) pairs, so comparisons never leave the
+     * entry array. Other elements are referenced by index only. After the entries are sorted,
+     * scatter() moves every element to its final position once.
+     */
+    template < std::random_access_iterator Iterator_t, class Comparator >
+    class IndexSort
+    {
+        using value_type = std::iter_value_t<Iterator_t>;
+
+        static constexpr bool copyKeys = std::is_trivially_copyable_v<value_type> and sizeof(value_type) <= 2 * sizeof(std::size_t);
+
+        struct KeyIndex
+        {
+            value_type key;
+            std::size_t index;
+        };
+
+    public:
+        using Entry_t = std::conditional_t<copyKeys, KeyIndex, std::size_t>;
+        using size_type = typename std::vector<Entry_t>::size_type;
+
+        IndexSort(Iterator_t begin, Iterator_t end, Comparator comparator, SortStability stability);
+
+        std::vector<Entry_t> &entries() noexcept;
+
+        /**
+         * @brief Strict weak ordering of entries.
+         */
+        bool less(const Entry_t &lhs, const Entry_t &rhs) const;
+
+        /**
+         * @brief Puts the smaller of the two entries first.
+         * @return True if the entries were swapped.
+         */
+        bool compareExchange(Entry_t &lhs, Entry_t &rhs) const;
+
+        /**
+         * @brief Moves element entries()[i] refers to into position i of the range.
+         * @param parallelFor Called as parallelFor(size, function) and must run function(first, last)
+         * over a partition of [0, size). Lets the caller run the moves in parallel.
+         */
+        template < class ParallelFor >
+        void scatter(ParallelFor &&parallelFor);
+
+    private:
+        const value_type &key(const Entry_t &entry) const;
+        static std::size_t index(const Entry_t &entry) noexcept;
+
+        Iterator_t begin_;
+        Comparator comparator_;
+        SortStability stability_;
+        std::vector<Entry_t> entries_;
+    };
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline IndexSort<Iterator_t, Comparator>::IndexSort(Iterator_t begin, Iterator_t end, Comparator comparator, SortStability stability)
+        : begin_(begin),
+          comparator_(std::move(comparator)),
+          stability_(stability)
+    {
+        std::size_t length = std::distance(begin, end);
+        entries_.reserve(length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if constexpr (copyKeys)
+                entries_.push_back(KeyIndex{begin[i], i});
+            else
+                entries_.push_back(i);
+        }
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline std::vector<typename IndexSort<Iterator_t, Comparator>::Entry_t> &IndexSort<Iterator_t, Comparator>::entries() noexcept
+    {
+        return entries_;
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline bool IndexSort<Iterator_t, Comparator>::less(const Entry_t &lhs, const Entry_t &rhs) const
+    {
+        if (comparator_(key(lhs), key(rhs)))
+            return true;
+        if (stability_ == SortStability::Unstable or comparator_(key(rhs), key(lhs)))
+            return false;
+        return index(lhs) < index(rhs);
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline bool IndexSort<Iterator_t, Comparator>::compareExchange(Entry_t &lhs, Entry_t &rhs) const
+    {
+        if (not less(rhs, lhs))
+            return false;
+        std::swap(lhs, rhs);
+        return true;
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    template <class ParallelFor>
+    inline void IndexSort<Iterator_t, Comparator>::scatter(ParallelFor &&parallelFor)
+    {
+        if constexpr (copyKeys)
+        {
+            parallelFor(entries_.size(), [this](size_type first, size_type last)
+                {
+                    for (auto i = first; i < last; ++i)
+                        begin_[i] = entries_[i].key;
+                });
+        }
+        else
+        {
+            std::vector<value_type> sorted;
+            sorted.reserve(entries_.size());
+            for (auto entry : entries_)
+                sorted.push_back(std::move(begin_[entry]));
+            parallelFor(entries_.size(), [this, &sorted](size_type first, size_type last)
+                {
+                    for (auto i = first; i < last; ++i)
+                        begin_[i] = std::move(sorted[i]);
+                });
+        }
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline const typename IndexSort<Iterator_t, Comparator>::value_type &IndexSort<Iterator_t, Comparator>::key(const Entry_t &entry) const
+    {
+        if constexpr (copyKeys)
+            return entry.key;
+        else
+            return begin_[entry];
+    }
+
+    template <std::random_access_iterator Iterator_t, class Comparator>
+    inline std::size_t IndexSort<Iterator_t, Comparator>::index(const Entry_t &entry) noexcept
+    {
+        if constexpr (copyKeys)
+            return entry.index;
+        else
+            return entry;
+    }
+}
+
+#endif
@@ -6,30 +6,289 @@
 #include <thread>
 #include <future>
 #include <execution>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <atomic>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 #include "CommonUtils/s0_type_traits.hpp"
 #include "CommonUtils/s0_utils.hpp"
 #include "s0_thread_pool.hpp"
+#include "s0_async.hpp"
+#include "s0_combinable.hpp"
+#include "s0_index_sort.hpp"
+#include "s0_simd.hpp"
+#include "s0_partitioner.hpp"
+#include "s0_blocked_range.hpp"
 
 namespace s0m4b0dY
 {
+/**
+ * @brief Where the chunks of a Threading algorithm run.
+ */
+enum class MemoryPlacement
+{
+	/**
+	 * @brief Any worker, the first chunk on the calling thread.
+	 */
+	Any,
+	/**
+	 * @brief Chunk i of n runs on a worker of pool node i * nodeCount() / n, the calling thread only waits.
+	 * Initializing the data with the same chunking (e.g. fill() with Partitioner::staticPartition())
+	 * first-touches every page on the node that later processes it. Needs a pinned pool, see ThreadPool::Affinity.
+	 */
+	NodeLocal
+};
+
+/**
+ * @brief back_insert_iterator into a container that can be resized up front and filled in place.
+ * Proxy references such as std::vector<bool>'s are excluded, neighbouring elements share a word.
+ */
+template <class OutputIterator_t>
+concept ResizableBackInserter = requires { typename OutputIterator_t::container_type; }
+	and std::same_as<OutputIterator_t, std::back_insert_iterator<typename OutputIterator_t::container_type> >
+	and std::random_access_iterator<typename OutputIterator_t::container_type::iterator>
+	and std::is_reference_v<std::iter_reference_t<typename OutputIterator_t::container_type::iterator> >
+	and std::default_initializable<typename OutputIterator_t::container_type::value_type>
+	and requires(typename OutputIterator_t::container_type &container) { container.resize(container.size()); };
+
+/**
+ * @brief Keys radix_sort() orders by: integers and IEEE 754 float or double.
+ */
+template <class T>
+concept RadixSortKey = (std::integral<T> and not std::same_as<T, bool>)
+	or (std::floating_point<T> and std::numeric_limits<T>::is_iec559 and (sizeof(T) == 4 or sizeof(T) == 8));
+
+template <class Iterator_t, class Stages_t>
+class Pipeline;
+
 class Threading
 {
 	template < class T >
 	using IteratorValueType = _helpers::IteratorValueType<T>;
+
+	// Runs its fused stages with make_ranges() and fork_join().
+	template <class Iterator_t, class Stages_t>
+	friend class Pipeline;
 public:
+	/**
+	 * @brief Uses ThreadPool::defaultPool(), shared by every default constructed Threading.
+	 */
+	Threading();
+
+	/**
+	 * @brief Borrows @p pool. The pool must outlive this object.
+	 */
+	explicit Threading(ThreadPool &pool, Partitioner partitioner = Partitioner(), MemoryPlacement placement = MemoryPlacement::Any);
+
+	/**
+	 * @brief Shares ownership of @p pool.
+	 */
+	explicit Threading(std::shared_ptr<ThreadPool> pool, Partitioner partitioner = Partitioner(), MemoryPlacement placement = MemoryPlacement::Any);
+
+	ThreadPool &pool() const noexcept;
+
+	/**
+	 * @brief Chunking policy of every algorithm, Partitioner::automatic() unless changed.
+	 */
+	const Partitioner &partitioner() const noexcept;
+
+	void setPartitioner(Partitioner partitioner) noexcept;
+
+	/**
+	 * @brief Copy on the same pool with another policy, for tuning a single call:
+	 * threading.with(Partitioner::fixedGrain(64)).transform(...)
+	 */
+	Threading with(Partitioner partitioner) const;
+
+	MemoryPlacement placement() const noexcept;
+
+	void setPlacement(MemoryPlacement placement) noexcept;
+
+	Threading with(MemoryPlacement placement) const;
+
+	/**
+	 * @brief Priority of every pool task an algorithm call creates, ThreadPool::Priority::Normal unless changed.
+	 * threading.with(ThreadPool::Priority::High).find_if(...) overtakes queued chunks of normal and low priority calls.
+	 */
+	ThreadPool::Priority priority() const noexcept;
+
+	void setPriority(ThreadPool::Priority priority) noexcept;
+
+	Threading with(ThreadPool::Priority priority) const;
+
+	/**
+	 * @note Contiguous ranges of 32/64 bit integers, float and double are summed by the SIMD kernels of s0_simd.hpp.
+	 * Floating point ranges only use them if @p summation is not FloatSummation::Ordered.
+	 */
 	template <_helpers::AddableIterator Iterator_t>
-	IteratorValueType<Iterator_t>::value_type reduce(Iterator_t begin, Iterator_t end);
+	IteratorValueType<Iterator_t>::value_type reduce(Iterator_t begin, Iterator_t end, FloatSummation summation = FloatSummation::Ordered);
 
 	template <_helpers::AddableIterator Iterator_t>
-	IteratorValueType<Iterator_t>::value_type reduce(Iterator_t begin, Iterator_t end, IteratorValueType<Iterator_t>::value_type initValue);
+	IteratorValueType<Iterator_t>::value_type reduce(Iterator_t begin, Iterator_t end, IteratorValueType<Iterator_t>::value_type initValue, FloatSummation summation = FloatSummation::Ordered);
+
+	/**
+	 * @brief Folds the range with @p binaryOperation, which must be associative. Chunk results are combined in order,
+	 * so the operation does not have to be commutative.
+	 * @return @p initValue for an empty range.
+	 */
+	template <class Iterator_t, class T, class BinaryOperation>
+	requires std::invocable<BinaryOperation&, T, T>
+	T reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation);
+
+	/**
+	 * @brief reduce() of unaryTransform(*it) without materializing the transformed values.
+	 */
+	template <class Iterator_t, class T, class BinaryOperation, class UnaryTransform>
+	T transform_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform);
+
+	/**
+	 * @brief reduce() of binaryTransform(*it1, *it2) over two ranges of equal length.
+	 */
+	template <class Iterator1_t, class Iterator2_t, class T, class BinaryOperation, class BinaryTransform>
+	T transform_reduce(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, T initValue, BinaryOperation binaryOperation, BinaryTransform binaryTransform);
+
+	/**
+	 * @brief Inner product of [begin1, end1) and the range starting at @p begin2.
+	 */
+	template <class Iterator1_t, class Iterator2_t, class T>
+	T transform_reduce(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, T initValue);
+
+	/**
+	 * @return The first smallest element or @p end for an empty range.
+	 */
+	template <std::forward_iterator Iterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<Iterator_t> > >
+	Iterator_t min_element(Iterator_t begin, Iterator_t end, Comparator comparator = Comparator());
+
+	/**
+	 * @return The first largest element or @p end for an empty range.
+	 */
+	template <std::forward_iterator Iterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<Iterator_t> > >
+	Iterator_t max_element(Iterator_t begin, Iterator_t end, Comparator comparator = Comparator());
+
+	/**
+	 * @return The first smallest and the last largest element, like std::minmax_element.
+	 */
+	template <std::forward_iterator Iterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<Iterator_t> > >
+	std::pair<Iterator_t, Iterator_t> minmax_element(Iterator_t begin, Iterator_t end, Comparator comparator = Comparator());
+
+	/**
+	 * @brief Parallel prefix fold with the associative @p binaryOperation, output[i] = input[0] op ... op input[i].
+	 * Two passes over the same chunks: chunk totals first, then every chunk is scanned from its carry in.
+	 * Output iterators which are not random access are written sequentially. Output may be @p begin.
+	 * @return End of the written output.
+	 */
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation = std::plus<> >
+	OutputIterator_t inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation = BinaryOperation());
+
+	/**
+	 * @brief Same as inclusive_scan() with @p initValue folded in front of the first element.
+	 */
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class T>
+	OutputIterator_t inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, T initValue);
+
+	/**
+	 * @brief output[i] = initValue op input[0] op ... op input[i - 1].
+	 */
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class T, class BinaryOperation = std::plus<> >
+	OutputIterator_t exclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, T initValue, BinaryOperation binaryOperation = BinaryOperation());
+
+	/**
+	 * @brief inclusive_scan() of unaryTransform(*it) without materializing the transformed values.
+	 */
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform>
+	OutputIterator_t transform_inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, UnaryTransform unaryTransform);
+
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform, class T>
+	OutputIterator_t transform_inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, UnaryTransform unaryTransform, T initValue);
 
+	template <std::forward_iterator Iterator_t, class OutputIterator_t, class T, class BinaryOperation, class UnaryTransform>
+	OutputIterator_t transform_exclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform);
+
+	/**
+	 * @return The leftmost match or @p end.
+	 * @note Chunks are scanned in blocks of findBlockSize elements and stop as soon as a match left of them is known.
+	 */
 	template <class Iterator_t, _helpers::Predicate<typename IteratorValueType<Iterator_t>::value_type> Predicate>
 	Iterator_t find_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction);
 
+	template <class Iterator_t, class T>
+	Iterator_t find(Iterator_t begin, Iterator_t end, const T &value);
+
+	template <class Iterator_t, class Predicate>
+	bool any_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction);
+
+	template <class Iterator_t, class Predicate>
+	bool all_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction);
+
+	template <class Iterator_t, class Predicate>
+	bool none_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction);
+
+	/**
+	 * @return The leftmost pair of elements for which @p binaryPredicate fails, {end1, begin2 + length} if there is none.
+	 */
+	template <class Iterator1_t, class Iterator2_t, class BinaryPredicate = std::equal_to<> >
+	std::pair<Iterator1_t, Iterator2_t> mismatch(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, BinaryPredicate binaryPredicate = BinaryPredicate());
+
+	template <class Iterator1_t, class Iterator2_t, class BinaryPredicate = std::equal_to<> >
+	bool equal(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, BinaryPredicate binaryPredicate = BinaryPredicate());
+
+	/**
+	 * @brief Ranges of different length are never equal.
+	 */
+	template <class Iterator1_t, class Iterator2_t, class BinaryPredicate = std::equal_to<> >
+	bool equal(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, Iterator2_t end2, BinaryPredicate binaryPredicate = BinaryPredicate());
+
+	static constexpr std::size_t findBlockSize = 1 << 10;
+
 	template <class Iterator_t, _helpers::Predicate<typename IteratorValueType<Iterator_t>::value_type> Predicate>
 	long long count_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction);
 
+	/**
+	 * @brief Count then scatter: every chunk counts its matches, a prefix sum of the counts gives every chunk
+	 * its own output slice and the chunks copy into their slices in parallel.
+	 * Random access outputs and ResizableBackInserter are written in parallel, other outputs sequentially.
+	 * @return End of the written output.
+	 */
+	template <std::random_access_iterator Iterator_t, class OutputIterator_t, class Predicate>
+	OutputIterator_t copy_if(Iterator_t begin, Iterator_t end, OutputIterator_t output, Predicate unaryFunction);
+
+	/**
+	 * @brief Keeps the order of the remaining elements. Every chunk compacts itself, then the kept blocks are
+	 * gathered through one scratch buffer.
+	 * @return New end of the range.
+	 */
+	template <std::random_access_iterator Iterator_t, class Predicate>
+	Iterator_t remove_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction);
+
+	/**
+	 * @brief Every chunk is partitioned on its own, then misplaced false and true elements are swapped pairwise in parallel.
+	 * Needs no extra memory and calls @p unaryFunction once per element.
+	 * @return Begin of the second group.
+	 */
+	template <std::random_access_iterator Iterator_t, class Predicate>
+	Iterator_t partition(Iterator_t begin, Iterator_t end, Predicate unaryFunction);
+
+	/**
+	 * @brief Same as partition() but keeps the relative order inside both groups. The blocks of the stable
+	 * partitioned chunks are gathered through one scratch buffer.
+	 */
+	template <std::random_access_iterator Iterator_t, class Predicate>
+	Iterator_t stable_partition(Iterator_t begin, Iterator_t end, Predicate unaryFunction);
+
+	/**
+	 * @note Random access outputs and back_inserter into a ResizableBackInserter container are written in parallel in place.
+	 * Any other output iterator gets the results through per chunk buffers.
+	 */
 	template <class InputIterator_t, class OutputIterator_t, class UnaryFunction,
 	          class = std::enable_if_t<
 				  std::is_assignable_v<
@@ -57,6 +316,9 @@ public:
 	          >
 	void transform_non_back_inserter(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction &&unaryFunction);
 
+	/**
+	 * @note Output is handled like in the unary transform().
+	 */
 	template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction,
 	          class = std::enable_if_t<
 				  std::is_assignable_v<
@@ -70,477 +332,2115 @@ public:
 	          >
 	void transform(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction);
 
-	/**
-	 * @note You should not use it if OutputIterator_t is back_inserter.
-	 */
-	template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction,
-	          class = std::enable_if_t<
-				  std::is_assignable_v<
-					  decltype(*std::declval<OutputIterator_t>()),
-					  decltype(std::declval<BinaryFunction>()(
-								   std::declval<typename IteratorValueType<InputIterator1_t>::value_type>(),
-								   std::declval<typename IteratorValueType<InputIterator2_t>::value_type>()
-								   ))
-					  >
-				  >
-	          >
-	void transform_non_back_inserter(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction);
+	/**
+	 * @note You should not use it if OutputIterator_t is back_inserter.
+	 */
+	template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction,
+	          class = std::enable_if_t<
+				  std::is_assignable_v<
+					  decltype(*std::declval<OutputIterator_t>()),
+					  decltype(std::declval<BinaryFunction>()(
+								   std::declval<typename IteratorValueType<InputIterator1_t>::value_type>(),
+								   std::declval<typename IteratorValueType<InputIterator2_t>::value_type>()
+								   ))
+					  >
+				  >
+	          >
+	void transform_non_back_inserter(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction);
+
+	/**
+	 * @note Length must be a power of 2.
+	 */
+	template < std::random_access_iterator InputIterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
+	void bitonic_sort(InputIterator_t begin, InputIterator_t end, Comparator comparator = Comparator(), SortStability stability = SortStability::Unstable);
+
+	template < std::random_access_iterator InputIterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
+	void odd_even_sort(InputIterator_t begin, InputIterator_t end, Comparator comparator = Comparator(), SortStability stability = SortStability::Unstable);
+
+	/**
+	 * @brief Calls unaryFunction(*it) for every element. @p unaryFunction is called concurrently.
+	 */
+	template <class Iterator_t, class UnaryFunction>
+	void for_each(Iterator_t begin, Iterator_t end, UnaryFunction &&unaryFunction);
+
+	/**
+	 * @return begin + count.
+	 */
+	template <class Iterator_t, class UnaryFunction>
+	Iterator_t for_each_n(Iterator_t begin, std::size_t count, UnaryFunction &&unaryFunction);
+
+	/**
+	 * @brief Assigns generator() to every element. @p generator is called concurrently and in no particular order.
+	 */
+	template <class Iterator_t, class Generator>
+	void generate(Iterator_t begin, Iterator_t end, Generator &&generator);
+
+	template <class Iterator_t, class T>
+	void fill(Iterator_t begin, Iterator_t end, const T &value);
+
+	/**
+	 * @brief Calls body(BlockedRange) for sub-ranges of [beginIndex, endIndex) split by the partitioner.
+	 * The body gets a whole sub-range, so it can hoist setup out of its loop and let it vectorize.
+	 */
+	template <std::integral Index_t, class Body>
+	void parallel_for(Index_t beginIndex, Index_t endIndex, Body &&body);
+
+	/**
+	 * @brief Same as parallel_for() with sub-ranges of @p grainSize indices.
+	 */
+	template <std::integral Index_t, class Body>
+	void parallel_for(Index_t beginIndex, Index_t endIndex, std::size_t grainSize, Body &&body);
+
+	/**
+	 * @brief Calls body(BlockedRange2d) for every tile of @p rowTile x @p colTile indices, tiles on the far edges may be smaller.
+	 * Pick tiles whose working set fits into L2. Runs of consecutive tiles in @p order go to the same task,
+	 * longer runs first, regardless of partitioner().
+	 */
+	template <std::integral Index_t, class Body>
+	void parallel_for(BlockedRange2d<Index_t> range, std::size_t rowTile, std::size_t colTile, Body &&body, TileOrder order = TileOrder::RowMajor);
+
+	template <std::integral Index_t, class Body>
+	void parallel_for(BlockedRange3d<Index_t> range, std::size_t pageTile, std::size_t rowTile, std::size_t colTile, Body &&body, TileOrder order = TileOrder::RowMajor);
+
+	static constexpr std::size_t defaultSortGrainSize = 1 << 14;
+
+	/**
+	 * @brief Parallel merge sort for any length.
+	 * @param grainSize Ranges up to this length are sorted sequentially by std::sort.
+	 */
+	template < std::random_access_iterator InputIterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
+	void sort(InputIterator_t begin, InputIterator_t end, Comparator comparator = Comparator(), std::size_t grainSize = defaultSortGrainSize);
+
+	/**
+	 * @brief Same as sort() but keeps the relative order of equal elements.
+	 */
+	template < std::random_access_iterator InputIterator_t, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
+	void stable_sort(InputIterator_t begin, InputIterator_t end, Comparator comparator = Comparator(), std::size_t grainSize = defaultSortGrainSize);
+
+	/**
+	 * @brief Stable LSD radix sort by the key itself, one pass per byte of the key, for any length.
+	 * Every pass counts the digits per chunk, turns the counts into output offsets with a prefix sum and
+	 * scatters every chunk to its offsets in parallel. Passes in which all keys share the digit are skipped.
+	 * Floating point keys are ordered like std::less, except -0.0 before 0.0 and NaNs at the ends by their sign.
+	 * @note The input is always split into one chunk per worker, regardless of partitioner().
+	 * Needs a scratch buffer as long as the input.
+	 */
+	template <std::random_access_iterator Iterator_t>
+	requires RadixSortKey<std::iter_value_t<Iterator_t> >
+	void radix_sort(Iterator_t begin, Iterator_t end);
+
+	/**
+	 * @brief Same as radix_sort() by keyFunction(element), e.g. a member of a record. @p keyFunction is called concurrently,
+	 * two times per element and pass.
+	 */
+	template <std::random_access_iterator Iterator_t, class KeyFunction>
+	requires RadixSortKey<std::remove_cvref_t<std::invoke_result_t<KeyFunction&, const std::iter_value_t<Iterator_t>&> > >
+	void radix_sort(Iterator_t begin, Iterator_t end, KeyFunction keyFunction);
+
+	/**
+	 * @brief Number of elements per bin, where keyFunction(element) is the bin. Negative keys and keys not below @p binCount are dropped.
+	 * Every thread counts into private bins of a Combinable, without atomics. The bins are summed in parallel at the end.
+	 * @note Keys have to be integers, bin floating point values with e.g. std::floor() to an integer first.
+	 */
+	template <class Iterator_t, class KeyFunction>
+	requires std::integral<std::remove_cvref_t<std::invoke_result_t<KeyFunction&, std::iter_reference_t<Iterator_t> > > >
+	std::vector<std::size_t> histogram(Iterator_t begin, Iterator_t end, std::size_t binCount, KeyFunction &&keyFunction);
+
+	/**
+	 * @brief Non-blocking reduce() for coroutines: co_await threading.async_reduce(...).
+	 * Every chunk runs on the pool, the last one to finish resumes the awaiting coroutine on its worker.
+	 * Functions are copied into the Async. The data has to stay valid until it is ready.
+	 */
+	template <_helpers::AddableIterator Iterator_t>
+	Async<typename IteratorValueType<Iterator_t>::value_type> async_reduce(Iterator_t begin, Iterator_t end, typename IteratorValueType<Iterator_t>::value_type initValue, FloatSummation summation = FloatSummation::Ordered);
+
+	template <class Iterator_t, class T, class BinaryOperation>
+	requires std::invocable<BinaryOperation&, T, T>
+	Async<T> async_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation);
+
+	template <class Iterator_t, class T, class BinaryOperation, class UnaryTransform>
+	Async<T> async_transform_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform);
+
+	template <class Iterator_t, class Predicate>
+	Async<long long> async_count_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction);
+
+	template <class Iterator_t, class Predicate>
+	Async<Iterator_t> async_find_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction);
+
+	/**
+	 * @return End of the output.
+	 */
+	template <std::random_access_iterator InputIterator_t, std::random_access_iterator OutputIterator_t, class UnaryFunction>
+	Async<OutputIterator_t> async_transform(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction unaryFunction);
+
+	template <class Iterator_t, class UnaryFunction>
+	Async<void> async_for_each(Iterator_t begin, Iterator_t end, UnaryFunction unaryFunction);
+
+	/**
+	 * @brief Runs function(threading) on a pool worker with a copy of this Threading, for algorithms without an async_ version.
+	 * The algorithm waits the way it always does, through the pool, so only pool workers are busy with it.
+	 */
+	template <class Function>
+	Async<std::invoke_result_t<Function&, Threading&> > async_invoke(Function function);
+
+private:
+	/**
+	 * @brief Below this many bins times threads, histogram() sums the bins on the calling thread.
+	 */
+	static constexpr std::size_t histogramParallelMergeSize = 1 << 15;
+
+	/**
+	 * @brief Up to this length radix_sort() runs std::stable_sort on the calling thread.
+	 */
+	static constexpr std::size_t radixSortSequentialSize = 1 << 14;
+	static constexpr unsigned radixDigitBits = 8;
+	static constexpr std::size_t radixBuckets = std::size_t(1) << radixDigitBits;
+	/**
+	 * @brief Size of the write-combining buffer per bucket. Every chunk stages values in 256 such buffers, which fit into L1,
+	 * and writes them out a cache line or two at a time instead of touching 256 output streams per value.
+	 */
+	static constexpr std::size_t radixBufferBytes = 128;
+
+	using RadixCounts = std::array<std::size_t, radixBuckets>;
+
+	struct RadixChunk
+	{
+		std::size_t first, last;
+		// Digit counts of the chunk, replaced by the output offset of every digit before the scatter.
+		RadixCounts offsets;
+	};
+
+	/**
+	 * @return Bits of @p key as an unsigned integer of the same size, ordered like the keys.
+	 */
+	template <RadixSortKey Key_t>
+	static auto radix_bits(Key_t key) noexcept;
+
+	/**
+	 * @brief One radix_sort() pass over the digit at @p shift, from @p source to @p destination.
+	 * @return false if all keys share the digit, then nothing is moved.
+	 */
+	template <class Source_t, class Destination_t, class BitsFunction>
+	bool radix_pass(Source_t source, Destination_t destination, std::vector<RadixChunk> &chunks, unsigned shift, BitsFunction &bitsFunction);
+
+	/**
+	 * @brief Chunked reduction engine behind every reduce-like algorithm.
+	 * Runs chunkFunction(first, last) for every non empty range on the pool and folds the results in range order
+	 * with combine(lhs, rhs).
+	 * @return Nothing if [begin, end) is empty.
+	 */
+	template <class Iterator_t, class ChunkFunction, class Combine>
+	auto reduce_ranges(Iterator_t begin, Iterator_t end, ChunkFunction &&chunkFunction, Combine &&combine);
+
+	/**
+	 * @brief Engine behind every scan. Exclusive scans always pass @p initValue, inclusive ones may leave it empty.
+	 */
+	template <bool Inclusive, class T, class Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform>
+	OutputIterator_t scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, std::optional<T> initValue, BinaryOperation &binaryOperation, UnaryTransform &unaryTransform);
+
+	/**
+	 * @brief Runs chunkFunction(first, last, offset) for every range on the pool, offset being the distance from @p begin to first.
+	 */
+	template <class Iterator_t, class ChunkFunction>
+	void for_each_range(Iterator_t begin, Iterator_t end, ChunkFunction &&chunkFunction);
+
+	template <class Container_t>
+	static Container_t &back_inserter_container(std::back_insert_iterator<Container_t> output);
+
+	/**
+	 * @brief Engine behind the find family. makeTest(first, offset) returns a callable which tests the element at its
+	 * position and moves to the next one. Chunks publish their matches through an atomic minimum and skip every block
+	 * right of it.
+	 * @return Position of the leftmost match or the length of the range.
+	 */
+	template <class Iterator_t, class MakeTest>
+	std::size_t find_first_index(Iterator_t begin, Iterator_t end, MakeTest &&makeTest);
+
+	/**
+	 * @brief Sum of the non empty range [first, last), vectorized where possible.
+	 */
+	template <class Iterator_t>
+	static IteratorValueType<Iterator_t>::value_type sum_range(Iterator_t first, Iterator_t last, FloatSummation summation);
+
+	/**
+	 * @brief Branchless count with independent counters for contiguous ranges.
+	 */
+	template <class Iterator_t, class Predicate>
+	static long long count_range(Iterator_t first, Iterator_t last, Predicate &unaryFunction);
+
+	/**
+	 * @brief Uninitialized storage for @p length values. Every value has to be constructed before the buffer is destroyed.
+	 */
+	template <class T>
+	struct ScratchBuffer
+	{
+		ScratchBuffer(Threading &threading, std::size_t length);
+		~ScratchBuffer();
+
+		ScratchBuffer(const ScratchBuffer &) = delete;
+		ScratchBuffer &operator=(const ScratchBuffer &) = delete;
+
+		Threading &threading;
+		std::size_t length;
+		T *data;
+	};
+
+	/**
+	 * @brief Moves the blocks [first, first + length) next to each other to @p output in parallel.
+	 * Blocks are staged in a scratch buffer, so they may overlap the output. Blocks already in place are not moved.
+	 * @return End of the output.
+	 */
+	template <class Iterator_t>
+	Iterator_t gather_blocks(const std::vector<std::pair<Iterator_t, std::size_t> > &blocks, Iterator_t output);
+
+	template <bool Stable, class Iterator_t, class Comparator>
+	void merge_sort(Iterator_t begin, Iterator_t end, Comparator &comparator, std::size_t grainSize);
+
+	/**
+	 * @brief Sorts [low, high) of @p values. The result ends up in @p other if @p resultInOther, otherwise in @p values.
+	 * The array not holding the result is used as scratch space.
+	 */
+	template <bool Stable, class Values_t, class Other_t, class Comparator>
+	void merge_sort_step(Values_t values, Other_t other, std::size_t low, std::size_t high, bool resultInOther, Comparator &comparator, std::size_t grainSize);
+
+	/**
+	 * @brief Stable merge of sorted input[low1, high1) and input[low2, high2) into output starting at @p outputLow.
+	 * Splits around the median of the longer run until the pieces are below @p grainSize.
+	 */
+	template <class Input_t, class Output_t, class Comparator>
+	void parallel_merge(Input_t input, std::size_t low1, std::size_t high1, std::size_t low2, std::size_t high2, Output_t output, std::size_t outputLow, Comparator &comparator, std::size_t grainSize);
+
+	/**
+	 * @brief Up to this many entries bitonic_merge() runs sequentially, task overhead would dominate below.
+	 */
+	static constexpr std::size_t bitonicMergeGrainSize = 1 << 12;
+
+	template<class IndexSort_t>
+	void bitonic_merge(IndexSort_t& indexSort, typename IndexSort_t::size_type low, typename IndexSort_t::size_type cnt);
+
+	/**
+	 * @brief Splits [begin, end) into ranges with partitioner_.
+	 */
+	template <class Iterator_t>
+	std::vector<std::pair<Iterator_t, Iterator_t> > make_ranges(Iterator_t begin, Iterator_t end) const;
+
+	/**
+	 * @brief Splits [0, size) with partitioner_ and runs function(first, last) for each range.
+	 */
+	template <class Function>
+	void parallel_for_index(std::size_t size, Function &&function);
+
+	template <class Function>
+	void parallel_for_index(std::size_t size, const Partitioner &partitioner, Function &&function);
+
+	/**
+	 * @brief Runs tileFunction(tile coordinates) for every tile of the grid, in tileSequence() order split guided over the pool.
+	 */
+	template <std::size_t Dimensions, class TileFunction>
+	void parallel_for_tiles(const std::array<std::size_t, Dimensions> &tileCounts, TileOrder order, TileFunction &&tileFunction);
+
+	/**
+	 * @brief Sub-range number @p tile of @p range cut into tiles of @p tileSize indices.
+	 */
+	template <std::integral Index_t>
+	static BlockedRange<Index_t> tile_range(BlockedRange<Index_t> range, std::size_t tileSize, std::size_t tile) noexcept;
+
+	/**
+	 * @brief Runs @p function for every range on the pool and joins them.
+	 * The first range is processed on the calling thread, unless placement_ is MemoryPlacement::NodeLocal.
+	 * @return Results in ranges order, nothing if @p function returns void.
+	 */
+	template <class Range_t, class Function>
+	auto fork_join(std::vector<Range_t> &ranges, Function &&function);
+
+	/**
+	 * @brief fork_join() without waiting. Every range runs on the pool, even the first one.
+	 * @return Async of the results in ranges order, Async<void> if @p function returns void.
+	 */
+	template <class Range_t, class Function>
+	auto async_fork_join(std::vector<Range_t> ranges, Function function);
+
+	std::shared_ptr<ThreadPool> pool_;
+	Partitioner partitioner_;
+	MemoryPlacement placement_;
+	ThreadPool::Priority priority_ = ThreadPool::Priority::Normal;
+};
+
+inline Threading::Threading()
+	: Threading(ThreadPool::defaultPool())
+{ }
+
+inline Threading::Threading(ThreadPool &pool, Partitioner partitioner, MemoryPlacement placement)
+	: pool_(&pool, [](ThreadPool *) {}),
+	  partitioner_(partitioner),
+	  placement_(placement)
+{ }
+
+inline Threading::Threading(std::shared_ptr<ThreadPool> pool, Partitioner partitioner, MemoryPlacement placement)
+	: pool_(std::move(pool)),
+	  partitioner_(partitioner),
+	  placement_(placement)
+{ }
+
+inline ThreadPool &Threading::pool() const noexcept
+{
+	return *pool_;
+}
+
+inline const Partitioner &Threading::partitioner() const noexcept
+{
+	return partitioner_;
+}
+
+inline void Threading::setPartitioner(Partitioner partitioner) noexcept
+{
+	partitioner_ = partitioner;
+}
+
+inline Threading Threading::with(Partitioner partitioner) const
+{
+	Threading threading(*this);
+	threading.setPartitioner(partitioner);
+	return threading;
+}
+
+inline MemoryPlacement Threading::placement() const noexcept
+{
+	return placement_;
+}
+
+inline void Threading::setPlacement(MemoryPlacement placement) noexcept
+{
+	placement_ = placement;
+}
+
+inline Threading Threading::with(MemoryPlacement placement) const
+{
+	Threading threading(*this);
+	threading.setPlacement(placement);
+	return threading;
+}
+
+inline ThreadPool::Priority Threading::priority() const noexcept
+{
+	return priority_;
+}
+
+inline void Threading::setPriority(ThreadPool::Priority priority) noexcept
+{
+	priority_ = priority;
+}
+
+inline Threading Threading::with(ThreadPool::Priority priority) const
+{
+	Threading threading(*this);
+	threading.setPriority(priority);
+	return threading;
+}
+
+template <class Iterator_t>
+inline std::vector<std::pair<Iterator_t, Iterator_t> > Threading::make_ranges(Iterator_t begin, Iterator_t end) const
+{
+	std::vector<std::pair<Iterator_t, Iterator_t> > ranges;
+	auto chunks = partitioner_.split(std::distance(begin, end), pool_->size());
+	ranges.reserve(chunks.size());
+	for (auto &[first, last] : chunks)
+	{
+		auto rangeEnd = std::next(begin, last - first);
+		ranges.emplace_back(begin, rangeEnd);
+		begin = rangeEnd;
+	}
+	return ranges;
+}
+
+template <class Range_t, class Function>
+inline auto Threading::fork_join(std::vector<Range_t> &ranges, Function &&function)
+{
+	using Result_t = std::invoke_result_t<Function&, Range_t&>;
+	std::vector<std::future<Result_t> > futures;
+	futures.reserve(ranges.size());
+	std::exception_ptr exception;
+	// Tasks the chunks submit inherit the priority from the chunk they run in.
+	ThreadPool::PriorityScope priorityScope(priority_);
+	bool nodeLocal = placement_ == MemoryPlacement::NodeLocal and pool_->nodeCount() > 1;
+	try
+	{
+		for (std::size_t i = nodeLocal ? 0 : 1; i < ranges.size(); ++i)
+		{
+			auto task = [&function, &range = ranges[i]]() -> Result_t { return function(range); };
+			if (nodeLocal)
+				futures.push_back(pool_->submitToNode(i * pool_->nodeCount() / ranges.size(), std::move(task)));
+			else
+				futures.push_back(pool_->submit(std::move(task)));
+		}
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+	std::optional<std::conditional_t<std::is_void_v<Result_t>, char, Result_t> > first;
+	if (not exception and not ranges.empty() and not nodeLocal)
+	{
+		try
+		{
+			if constexpr (std::is_void_v<Result_t>)
+				function(ranges.front());
+			else
+				first.emplace(function(ranges.front()));
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+	}
+	// Tasks reference ranges and function, so every one of them has to finish before we leave.
+	// Waiting through the pool keeps this thread busy if it is a pool worker itself.
+	std::conditional_t<std::is_void_v<Result_t>, char, std::vector<Result_t> > results;
+	if constexpr (not std::is_void_v<Result_t>)
+	{
+		results.reserve(ranges.size());
+		if (first.has_value())
+			results.push_back(std::move(first).value());
+	}
+	for (auto &future : futures)
+	{
+		try
+		{
+			if constexpr (std::is_void_v<Result_t>)
+				pool_->wait(future);
+			else
+				results.push_back(pool_->wait(future));
+		}
+		catch (...)
+		{
+			if (not exception)
+				exception = std::current_exception();
+		}
+	}
+	if (exception)
+		std::rethrow_exception(exception);
+	if constexpr (not std::is_void_v<Result_t>)
+		return results;
+}
+
+template <class Iterator_t>
+inline _helpers::IteratorValueType<Iterator_t>::value_type Threading::sum_range(Iterator_t first, Iterator_t last, FloatSummation summation)
+{
+	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
+	if constexpr (std::contiguous_iterator<Iterator_t> and simd::isSummable<value_type>)
+	{
+		const value_type *data = std::to_address(first);
+		std::size_t size = last - first;
+		if constexpr (std::is_integral_v<value_type>)
+			return simd::sum(data, size);
+		else if (summation == FloatSummation::Reassociate)
+			return simd::sum(data, size);
+		else if (summation == FloatSummation::Pairwise)
+			return simd::pairwise_sum(data, size);
+	}
+	auto it = first;
+	value_type result = *it++;
+	for (; it != last; it++)
+	{
+		result += *it;
+	}
+	return result;
+}
+
+template <class Iterator_t, class Predicate>
+inline long long Threading::count_range(Iterator_t first, Iterator_t last, Predicate &unaryFunction)
+{
+	using Count_t = long long;
+	if constexpr (std::contiguous_iterator<Iterator_t>)
+	{
+		auto data = std::to_address(first);
+		std::size_t size = last - first;
+		Count_t count0 = 0, count1 = 0, count2 = 0, count3 = 0;
+		std::size_t i = 0;
+		for (; i + 4 <= size; i += 4)
+		{
+			count0 += static_cast<bool>(unaryFunction(data[i]));
+			count1 += static_cast<bool>(unaryFunction(data[i + 1]));
+			count2 += static_cast<bool>(unaryFunction(data[i + 2]));
+			count3 += static_cast<bool>(unaryFunction(data[i + 3]));
+		}
+		for (; i < size; ++i)
+			count0 += static_cast<bool>(unaryFunction(data[i]));
+		return (count0 + count1) + (count2 + count3);
+	}
+	else
+	{
+		Count_t count = 0;
+		for (auto it = first; it != last; it++)
+		{
+			if (unaryFunction(*it))
+				count++;
+		}
+		return count;
+	}
+}
+
+template <class Iterator_t, class ChunkFunction, class Combine>
+inline auto Threading::reduce_ranges(Iterator_t begin, Iterator_t end, ChunkFunction &&chunkFunction, Combine &&combine)
+{
+	using Result_t = std::invoke_result_t<ChunkFunction&, Iterator_t, Iterator_t>;
+	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+	auto results = fork_join(ranges, [&chunkFunction](const std::pair<Iterator_t, Iterator_t> &range) -> std::optional<Result_t>
+		{
+			if (range.first == range.second)
+			{
+				return std::nullopt;
+			}
+			return chunkFunction(range.first, range.second);
+		});
+	std::optional<Result_t> result;
+	for (std::optional<Result_t> &value : results)
+	{
+		if (not value.has_value())
+			continue;
+		if (result.has_value())
+			result.emplace(combine(std::move(result).value(), std::move(value).value()));
+		else
+			result = std::move(value);
+	}
+	return result;
+}
+
+template <_helpers::AddableIterator Iterator_t>
+inline _helpers::IteratorValueType<Iterator_t>::value_type Threading::reduce(Iterator_t begin, Iterator_t end, FloatSummation summation)
+{
+	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
+	auto result = reduce_ranges(begin, end, [summation](Iterator_t first, Iterator_t last)
+		{
+			return sum_range(first, last, summation);
+		}, [](value_type lhs, value_type rhs)
+		{
+			lhs += std::move(rhs);
+			return lhs;
+		});
+	if (not result.has_value())
+		throw std::logic_error("Zero values in reduce found");
+	return std::move(result).value();
+}
+
+template <_helpers::AddableIterator Iterator_t>
+inline _helpers::IteratorValueType<Iterator_t>::value_type Threading::reduce(Iterator_t begin, Iterator_t end, IteratorValueType<Iterator_t>::value_type initValue, FloatSummation summation)
+{
+	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
+	auto result = reduce_ranges(begin, end, [summation](Iterator_t first, Iterator_t last)
+		{
+			return sum_range(first, last, summation);
+		}, [](value_type lhs, value_type rhs)
+		{
+			lhs += std::move(rhs);
+			return lhs;
+		});
+	if (result.has_value())
+		initValue += std::move(result).value();
+	return initValue;
+}
+
+template <class Iterator_t, class T, class BinaryOperation>
+requires std::invocable<BinaryOperation&, T, T>
+inline T Threading::reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation)
+{
+	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
+	constexpr bool isPlus = std::is_same_v<BinaryOperation, std::plus<> > or std::is_same_v<BinaryOperation, std::plus<T> >;
+	// Integer addition is associative, so the vectorized sum gives the same result.
+	if constexpr (isPlus and std::is_same_v<T, value_type> and std::is_integral_v<T>)
+		return reduce(begin, end, std::move(initValue));
+	else
+		return transform_reduce(begin, end, std::move(initValue), std::move(binaryOperation), std::identity());
+}
+
+template <class Iterator_t, class T, class BinaryOperation, class UnaryTransform>
+inline T Threading::transform_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform)
+{
+	auto result = reduce_ranges(begin, end, [&binaryOperation, &unaryTransform](Iterator_t first, Iterator_t last)
+		{
+			T result = unaryTransform(*first);
+			for (++first; first != last; ++first)
+			{
+				result = binaryOperation(std::move(result), unaryTransform(*first));
+			}
+			return result;
+		}, binaryOperation);
+	if (result.has_value())
+		return binaryOperation(std::move(initValue), std::move(result).value());
+	return initValue;
+}
+
+template <class Iterator1_t, class Iterator2_t, class T, class BinaryOperation, class BinaryTransform>
+inline T Threading::transform_reduce(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, T initValue, BinaryOperation binaryOperation, BinaryTransform binaryTransform)
+{
+	auto result = reduce_ranges(begin1, end1, [&binaryOperation, &binaryTransform, begin1, begin2](Iterator1_t first, Iterator1_t last)
+		{
+			auto second = begin2;
+			std::advance(second, std::distance(begin1, first));
+			T result = binaryTransform(*first, *second);
+			for (++first, ++second; first != last; ++first, ++second)
+			{
+				result = binaryOperation(std::move(result), binaryTransform(*first, *second));
+			}
+			return result;
+		}, binaryOperation);
+	if (result.has_value())
+		return binaryOperation(std::move(initValue), std::move(result).value());
+	return initValue;
+}
+
+template <class Iterator1_t, class Iterator2_t, class T>
+inline T Threading::transform_reduce(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, T initValue)
+{
+	return transform_reduce(begin1, end1, begin2, std::move(initValue), std::plus<>(), std::multiplies<>());
+}
+
+template <std::forward_iterator Iterator_t, class Comparator>
+inline Iterator_t Threading::min_element(Iterator_t begin, Iterator_t end, Comparator comparator)
+{
+	auto result = reduce_ranges(begin, end, [&comparator](Iterator_t first, Iterator_t last)
+		{
+			return std::min_element(first, last, comparator);
+		}, [&comparator](Iterator_t lhs, Iterator_t rhs)
+		{
+			return comparator(*rhs, *lhs) ? rhs : lhs;
+		});
+	return result.value_or(end);
+}
+
+template <std::forward_iterator Iterator_t, class Comparator>
+inline Iterator_t Threading::max_element(Iterator_t begin, Iterator_t end, Comparator comparator)
+{
+	auto result = reduce_ranges(begin, end, [&comparator](Iterator_t first, Iterator_t last)
+		{
+			return std::max_element(first, last, comparator);
+		}, [&comparator](Iterator_t lhs, Iterator_t rhs)
+		{
+			return comparator(*lhs, *rhs) ? rhs : lhs;
+		});
+	return result.value_or(end);
+}
+
+template <std::forward_iterator Iterator_t, class Comparator>
+inline std::pair<Iterator_t, Iterator_t> Threading::minmax_element(Iterator_t begin, Iterator_t end, Comparator comparator)
+{
+	using Result_t = std::pair<Iterator_t, Iterator_t>;
+	auto result = reduce_ranges(begin, end, [&comparator](Iterator_t first, Iterator_t last) -> Result_t
+		{
+			auto [min, max] = std::minmax_element(first, last, comparator);
+			return {min, max};
+		}, [&comparator](const Result_t &lhs, const Result_t &rhs) -> Result_t
+		{
+			return {comparator(*rhs.first, *lhs.first) ? rhs.first : lhs.first,
+			        comparator(*rhs.second, *lhs.second) ? lhs.second : rhs.second};
+		});
+	return result.value_or(Result_t{end, end});
+}
+
+template <bool Inclusive, class T, class Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform>
+inline OutputIterator_t Threading::scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, std::optional<T> initValue, BinaryOperation &binaryOperation, UnaryTransform &unaryTransform)
+{
+	// Scans [first, last) into localOutput starting from carry. The input is read before the output is written,
+	// so in place scans work.
+	auto scanRange = [&binaryOperation, &unaryTransform](Iterator_t first, Iterator_t last, auto localOutput, std::optional<T> carry)
+		{
+			for (; first != last; ++first, ++localOutput)
+			{
+				if constexpr (Inclusive)
+				{
+					if (carry.has_value())
+						carry.emplace(binaryOperation(std::move(carry).value(), unaryTransform(*first)));
+					else
+						carry.emplace(unaryTransform(*first));
+					*localOutput = *carry;
+				}
+				else
+				{
+					T next = binaryOperation(*carry, unaryTransform(*first));
+					*localOutput = std::move(*carry);
+					carry.emplace(std::move(next));
+				}
+			}
+			return localOutput;
+		};
+	if constexpr (not std::random_access_iterator<OutputIterator_t>)
+	{
+		return scanRange(begin, end, output, std::move(initValue));
+	}
+	else
+	{
+		struct Chunk
+		{
+			Iterator_t first, last;
+			std::optional<T> carry;
+		};
+		std::vector<Chunk> chunks;
+		for (auto &range : make_ranges(begin, end))
+		{
+			if (range.first != range.second)
+				chunks.push_back(Chunk{range.first, range.second, std::nullopt});
+		}
+		// First pass: total of every chunk but the last one, whose total nobody needs.
+		auto totals = fork_join(chunks, [&binaryOperation, &unaryTransform, &chunks](const Chunk &chunk) -> std::optional<T>
+			{
+				if (&chunk == &chunks.back())
+					return std::nullopt;
+				auto it = chunk.first;
+				T total = unaryTransform(*it);
+				for (++it; it != chunk.last; ++it)
+				{
+					total = binaryOperation(std::move(total), unaryTransform(*it));
+				}
+				return total;
+			});
+		std::optional<T> carry = std::move(initValue);
+		for (std::size_t i = 0; i < chunks.size(); ++i)
+		{
+			chunks[i].carry = carry;
+			if (i + 1 == chunks.size())
+				break;
+			if (carry.has_value())
+				carry.emplace(binaryOperation(std::move(carry).value(), std::move(totals[i]).value()));
+			else
+				carry = std::move(totals[i]);
+		}
+		// Second pass: every chunk scans from its carry in.
+		fork_join(chunks, [&scanRange, begin, output](Chunk &chunk)
+			{
+				scanRange(chunk.first, chunk.last, output + std::distance(begin, chunk.first), std::move(chunk.carry));
+			});
+		return output + std::distance(begin, end);
+	}
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation>
+inline OutputIterator_t Threading::inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation)
+{
+	using T = std::iter_value_t<Iterator_t>;
+	std::identity identity;
+	return scan<true, T>(begin, end, output, std::nullopt, binaryOperation, identity);
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class T>
+inline OutputIterator_t Threading::inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, T initValue)
+{
+	std::identity identity;
+	return scan<true, T>(begin, end, output, std::move(initValue), binaryOperation, identity);
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class T, class BinaryOperation>
+inline OutputIterator_t Threading::exclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, T initValue, BinaryOperation binaryOperation)
+{
+	std::identity identity;
+	return scan<false, T>(begin, end, output, std::move(initValue), binaryOperation, identity);
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform>
+inline OutputIterator_t Threading::transform_inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, UnaryTransform unaryTransform)
+{
+	using T = std::decay_t<std::invoke_result_t<UnaryTransform&, std::iter_reference_t<Iterator_t> > >;
+	return scan<true, T>(begin, end, output, std::nullopt, binaryOperation, unaryTransform);
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class BinaryOperation, class UnaryTransform, class T>
+inline OutputIterator_t Threading::transform_inclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, BinaryOperation binaryOperation, UnaryTransform unaryTransform, T initValue)
+{
+	return scan<true, T>(begin, end, output, std::move(initValue), binaryOperation, unaryTransform);
+}
+
+template <std::forward_iterator Iterator_t, class OutputIterator_t, class T, class BinaryOperation, class UnaryTransform>
+inline OutputIterator_t Threading::transform_exclusive_scan(Iterator_t begin, Iterator_t end, OutputIterator_t output, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform)
+{
+	return scan<false, T>(begin, end, output, std::move(initValue), binaryOperation, unaryTransform);
+}
+
+template <class Iterator_t, class MakeTest>
+inline std::size_t Threading::find_first_index(Iterator_t begin, Iterator_t end, MakeTest &&makeTest)
+{
+	std::atomic<std::size_t> best = std::distance(begin, end);
+	for_each_range(begin, end, [&best, &makeTest](Iterator_t first, Iterator_t last, std::size_t offset)
+		{
+			auto test = makeTest(first, offset);
+			std::size_t length = std::distance(first, last);
+			for (std::size_t blockBegin = 0; blockBegin < length; blockBegin += findBlockSize)
+			{
+				if (best.load(std::memory_order_relaxed) <= offset + blockBegin)
+					return;
+				auto blockEnd = std::min(blockBegin + findBlockSize, length);
+				for (auto i = blockBegin; i < blockEnd; ++i)
+				{
+					if (test())
+					{
+						auto current = best.load(std::memory_order_relaxed);
+						while (offset + i < current and not best.compare_exchange_weak(current, offset + i, std::memory_order_relaxed))
+						{ }
+						return;
+					}
+				}
+			}
+		});
+	return best.load(std::memory_order_relaxed);
+}
+
+template <class Iterator_t, _helpers::Predicate<typename _helpers::IteratorValueType<Iterator_t>::value_type> Predicate>
+inline Iterator_t Threading::find_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+{
+	auto index = find_first_index(begin, end, [&unaryFunction](Iterator_t first, std::size_t)
+		{
+			return [&unaryFunction, it = first]() mutable { return static_cast<bool>(unaryFunction(*it++)); };
+		});
+	return std::next(begin, index);
+}
+
+template <class Iterator_t, class T>
+inline Iterator_t Threading::find(Iterator_t begin, Iterator_t end, const T &value)
+{
+	return find_if(begin, end, [&value](const auto &element) { return element == value; });
+}
+
+template <class Iterator_t, class Predicate>
+inline bool Threading::any_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+{
+	return find_if(begin, end, unaryFunction) != end;
+}
+
+template <class Iterator_t, class Predicate>
+inline bool Threading::all_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+{
+	return find_if(begin, end, [&unaryFunction](const auto &element) { return not unaryFunction(element); }) == end;
+}
+
+template <class Iterator_t, class Predicate>
+inline bool Threading::none_of(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+{
+	return not any_of(begin, end, unaryFunction);
+}
+
+template <class Iterator1_t, class Iterator2_t, class BinaryPredicate>
+inline std::pair<Iterator1_t, Iterator2_t> Threading::mismatch(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, BinaryPredicate binaryPredicate)
+{
+	auto index = find_first_index(begin1, end1, [&binaryPredicate, begin2](Iterator1_t first, std::size_t offset)
+		{
+			return [&binaryPredicate, it1 = first, it2 = std::next(begin2, offset)]() mutable
+				{
+					return not binaryPredicate(*it1++, *it2++);
+				};
+		});
+	return {std::next(begin1, index), std::next(begin2, index)};
+}
+
+template <class Iterator1_t, class Iterator2_t, class BinaryPredicate>
+inline bool Threading::equal(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, BinaryPredicate binaryPredicate)
+{
+	return mismatch(begin1, end1, begin2, std::move(binaryPredicate)).first == end1;
+}
+
+template <class Iterator1_t, class Iterator2_t, class BinaryPredicate>
+inline bool Threading::equal(Iterator1_t begin1, Iterator1_t end1, Iterator2_t begin2, Iterator2_t end2, BinaryPredicate binaryPredicate)
+{
+	if (std::distance(begin1, end1) != std::distance(begin2, end2))
+		return false;
+	return equal(begin1, end1, begin2, std::move(binaryPredicate));
+}
+template <class Iterator_t, _helpers::Predicate<typename _helpers::IteratorValueType<Iterator_t>::value_type> Predicate>
+inline long long Threading::count_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+{
+	using Count_t = long long;
+	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+	auto results = fork_join(ranges, [&unaryFunction](const std::pair<Iterator_t, Iterator_t> &range)
+		{
+			return count_range(range.first, range.second, unaryFunction);
+		});
+	Count_t count = 0;
+	for (auto localResult : results)
+		count += localResult;
+	return count;
+}
+
+template <class T>
+inline Threading::ScratchBuffer<T>::ScratchBuffer(Threading &threading, std::size_t length)
+	: threading(threading),
+	  length(length),
+	  data(std::allocator<T>().allocate(length))
+{ }
+
+template <class T>
+inline Threading::ScratchBuffer<T>::~ScratchBuffer()
+{
+	if constexpr (not std::is_trivially_destructible_v<T>)
+		threading.parallel_for_index(length, [this](std::size_t first, std::size_t last) { std::destroy(data + first, data + last); });
+	std::allocator<T>().deallocate(data, length);
+}
+
+template <class Iterator_t>
+inline Iterator_t Threading::gather_blocks(const std::vector<std::pair<Iterator_t, std::size_t> > &blocks, Iterator_t output)
+{
+	using value_type = std::iter_value_t<Iterator_t>;
+	struct Move
+	{
+		Iterator_t first;
+		std::size_t length, outputOffset, bufferOffset;
+	};
+	std::vector<Move> moves;
+	std::size_t outputOffset = 0, bufferLength = 0;
+	for (auto &[first, length] : blocks)
+	{
+		// A block at its destination is not overlapped by any other destination, so it can stay.
+		if (length != 0 and first != output + outputOffset)
+		{
+			moves.push_back(Move{first, length, outputOffset, bufferLength});
+			bufferLength += length;
+		}
+		outputOffset += length;
+	}
+	if (moves.empty())
+		return output + outputOffset;
+	ScratchBuffer<value_type> buffer(*this, bufferLength);
+	fork_join(moves, [&buffer](const Move &move)
+		{
+			std::uninitialized_move(move.first, move.first + move.length, buffer.data + move.bufferOffset);
+		});
+	fork_join(moves, [&buffer, output](const Move &move)
+		{
+			std::move(buffer.data + move.bufferOffset, buffer.data + move.bufferOffset + move.length, output + move.outputOffset);
+		});
+	return output + outputOffset;
+}
+
+template <std::random_access_iterator Iterator_t, class OutputIterator_t, class Predicate>
+inline OutputIterator_t Threading::copy_if(Iterator_t begin, Iterator_t end, OutputIterator_t output, Predicate unaryFunction)
+{
+	if constexpr (std::random_access_iterator<OutputIterator_t> or ResizableBackInserter<OutputIterator_t>)
+	{
+		struct Chunk
+		{
+			Iterator_t first, last;
+			std::size_t offset;
+		};
+		std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+		auto counts = fork_join(ranges, [&unaryFunction](const std::pair<Iterator_t, Iterator_t> &range)
+			{
+				return count_range(range.first, range.second, unaryFunction);
+			});
+		std::vector<Chunk> chunks;
+		chunks.reserve(ranges.size());
+		std::size_t total = 0;
+		for (std::size_t i = 0; i < ranges.size(); ++i)
+		{
+			chunks.push_back(Chunk{ranges[i].first, ranges[i].second, total});
+			total += counts[i];
+		}
+		auto scatter = [this, &chunks, &unaryFunction](auto localOutput)
+			{
+				fork_join(chunks, [&unaryFunction, localOutput](const Chunk &chunk)
+					{
+						std::copy_if(chunk.first, chunk.last, localOutput + chunk.offset, std::ref(unaryFunction));
+					});
+			};
+		if constexpr (std::random_access_iterator<OutputIterator_t>)
+		{
+			scatter(output);
+			return output + total;
+		}
+		else
+		{
+			auto &container = back_inserter_container(output);
+			auto oldSize = container.size();
+			container.resize(oldSize + total);
+			try
+			{
+				scatter(container.begin() + oldSize);
+			}
+			catch (...)
+			{
+				container.resize(oldSize);
+				throw;
+			}
+			return output;
+		}
+	}
+	else
+	{
+		return std::copy_if(begin, end, output, std::ref(unaryFunction));
+	}
+}
+
+template <std::random_access_iterator Iterator_t, class Predicate>
+inline Iterator_t Threading::remove_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction)
+{
+	if constexpr (not std::is_nothrow_move_constructible_v<std::iter_value_t<Iterator_t> >)
+	{
+		return std::remove_if(begin, end, std::ref(unaryFunction));
+	}
+	else
+	{
+		std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+		auto blocks = fork_join(ranges, [&unaryFunction](const std::pair<Iterator_t, Iterator_t> &range)
+			{
+				auto keptEnd = std::remove_if(range.first, range.second, std::ref(unaryFunction));
+				return std::pair<Iterator_t, std::size_t>(range.first, keptEnd - range.first);
+			});
+		return gather_blocks(blocks, begin);
+	}
+}
+
+template <std::random_access_iterator Iterator_t, class Predicate>
+inline Iterator_t Threading::partition(Iterator_t begin, Iterator_t end, Predicate unaryFunction)
+{
+	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+	auto middles = fork_join(ranges, [&unaryFunction](const std::pair<Iterator_t, Iterator_t> &range)
+		{
+			return std::partition(range.first, range.second, std::ref(unaryFunction));
+		});
+	auto middle = begin;
+	for (std::size_t i = 0; i < ranges.size(); ++i)
+		middle += middles[i] - ranges[i].first;
+	// False elements before middle and true elements after it are the same in number. The k-th misplaced false
+	// element is swapped with the k-th misplaced true element, both live in a short list of contiguous blocks.
+	std::vector<std::pair<Iterator_t, Iterator_t> > misplacedFalse, misplacedTrue;
+	for (std::size_t i = 0; i < ranges.size(); ++i)
+	{
+		if (middles[i] < middle and middles[i] != ranges[i].second)
+			misplacedFalse.emplace_back(middles[i], std::min(ranges[i].second, middle));
+		if (middles[i] > middle and middles[i] != ranges[i].first)
+			misplacedTrue.emplace_back(std::max(ranges[i].first, middle), middles[i]);
+	}
+	auto blockStarts = [](const std::vector<std::pair<Iterator_t, Iterator_t> > &blocks)
+		{
+			std::vector<std::size_t> starts;
+			starts.reserve(blocks.size() + 1);
+			starts.push_back(0);
+			for (auto &block : blocks)
+				starts.push_back(starts.back() + (block.second - block.first));
+			return starts;
+		};
+	auto falseStarts = blockStarts(misplacedFalse);
+	auto trueStarts = blockStarts(misplacedTrue);
+	assert(falseStarts.back() == trueStarts.back());
+	parallel_for_index(falseStarts.back(), [&](std::size_t first, std::size_t last)
+		{
+			auto falseBlock = std::upper_bound(falseStarts.begin(), falseStarts.end(), first) - falseStarts.begin() - 1;
+			auto trueBlock = std::upper_bound(trueStarts.begin(), trueStarts.end(), first) - trueStarts.begin() - 1;
+			auto falseIt = misplacedFalse[falseBlock].first + (first - falseStarts[falseBlock]);
+			auto trueIt = misplacedTrue[trueBlock].first + (first - trueStarts[trueBlock]);
+			for (auto k = first; k < last; ++k)
+			{
+				if (falseIt == misplacedFalse[falseBlock].second)
+					falseIt = misplacedFalse[++falseBlock].first;
+				if (trueIt == misplacedTrue[trueBlock].second)
+					trueIt = misplacedTrue[++trueBlock].first;
+				std::iter_swap(falseIt++, trueIt++);
+			}
+		});
+	return middle;
+}
+
+template <std::random_access_iterator Iterator_t, class Predicate>
+inline Iterator_t Threading::stable_partition(Iterator_t begin, Iterator_t end, Predicate unaryFunction)
+{
+	if constexpr (not std::is_nothrow_move_constructible_v<std::iter_value_t<Iterator_t> >)
+	{
+		return std::stable_partition(begin, end, std::ref(unaryFunction));
+	}
+	else
+	{
+		std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+		auto middles = fork_join(ranges, [&unaryFunction](const std::pair<Iterator_t, Iterator_t> &range)
+			{
+				return std::stable_partition(range.first, range.second, std::ref(unaryFunction));
+			});
+		// All true blocks in chunk order, then all false blocks.
+		std::vector<std::pair<Iterator_t, std::size_t> > blocks;
+		blocks.reserve(2 * ranges.size());
+		std::size_t trueCount = 0;
+		for (std::size_t i = 0; i < ranges.size(); ++i)
+		{
+			blocks.emplace_back(ranges[i].first, middles[i] - ranges[i].first);
+			trueCount += middles[i] - ranges[i].first;
+		}
+		for (std::size_t i = 0; i < ranges.size(); ++i)
+			blocks.emplace_back(middles[i], ranges[i].second - middles[i]);
+		gather_blocks(blocks, begin);
+		return begin + trueCount;
+	}
+}
+
+template <class Iterator_t, class ChunkFunction>
+inline void Threading::for_each_range(Iterator_t begin, Iterator_t end, ChunkFunction &&chunkFunction)
+{
+	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = make_ranges(begin, end);
+	fork_join(ranges, [&chunkFunction, begin](const std::pair<Iterator_t, Iterator_t> &range)
+		{
+			chunkFunction(range.first, range.second, static_cast<std::size_t>(std::distance(begin, range.first)));
+		});
+}
+
+template <class Container_t>
+inline Container_t &Threading::back_inserter_container(std::back_insert_iterator<Container_t> output)
+{
+	// back_insert_iterator keeps the container in a protected member.
+	struct Access : std::back_insert_iterator<Container_t>
+	{
+		static Container_t &get(const std::back_insert_iterator<Container_t> &output)
+		{
+			return *(output.*&Access::container);
+		}
+	};
+	return Access::get(output);
+}
+
+template <class InputIterator_t, class OutputIterator_t, class UnaryFunction, class>
+inline void Threading::transform(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction &&unaryFunction)
+{
+	using InputValue_t = ::_helpers::IteratorValueType<InputIterator_t>::value_type;
+	using UnaryFunctionReturn_t = std::invoke_result_t<UnaryFunction, InputValue_t>;
+	if constexpr (std::random_access_iterator<OutputIterator_t>)
+	{
+		for_each_range(begin, end, [&unaryFunction, output](InputIterator_t first, InputIterator_t last, std::size_t offset)
+			{
+				for (auto localOutput = output + offset; first != last; ++first, ++localOutput)
+				{
+					*localOutput = unaryFunction(*first);
+				}
+			});
+	}
+	else if constexpr (ResizableBackInserter<OutputIterator_t>)
+	{
+		auto &container = back_inserter_container(output);
+		auto oldSize = container.size();
+		container.resize(oldSize + std::distance(begin, end));
+		try
+		{
+			transform(begin, end, container.begin() + oldSize, unaryFunction);
+		}
+		catch (...)
+		{
+			container.resize(oldSize);
+			throw;
+		}
+	}
+	else
+	{
+		std::vector<std::pair<InputIterator_t, InputIterator_t> > ranges = make_ranges(begin, end);
+		auto results = fork_join(ranges, [&unaryFunction](const std::pair<InputIterator_t, InputIterator_t> &range)
+			{
+				std::vector<UnaryFunctionReturn_t> localResult;
+				localResult.reserve(std::distance(range.first, range.second));
+				for (auto it = range.first; it != range.second; it++)
+				{
+					localResult.push_back(unaryFunction(*it));
+				}
+				return localResult;
+			});
+		for (auto &localResult : results)
+		{
+			for (auto &&value : localResult)
+			{
+				if constexpr (std::is_move_assignable_v<UnaryFunctionReturn_t>)
+				{
+					*output++ = std::move(value);
+				}
+				else
+				{
+					*output++ = value;
+				}
+			}
+		}
+	}
+}
+
+template <class InputIterator_t, class OutputIterator_t, class UnaryFunction, class>
+inline void Threading::transform_non_back_inserter(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction &&unaryFunction)
+{
+	std::vector<std::pair<InputIterator_t, InputIterator_t> > ranges = make_ranges(begin, end);
+	fork_join(ranges, [&unaryFunction, begin, output](const std::pair<InputIterator_t, InputIterator_t> &range)
+		{
+			auto localOutput = output;
+			std::advance(localOutput, range.first - begin);
+			for (auto it = range.first; it != range.second; it++)
+			{
+				*localOutput++ = unaryFunction(*it);
+			}
+		});
+}
+
+template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction, class>
+inline void Threading::transform(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction)
+{
+	using InputValue1_t = ::_helpers::IteratorValueType<InputIterator1_t>::value_type;
+	using InputValue2_t = ::_helpers::IteratorValueType<InputIterator2_t>::value_type;
+	using BinaryFunctionReturn_t = std::invoke_result_t<BinaryFunction, InputValue1_t, InputValue2_t>;
+	if constexpr (std::random_access_iterator<OutputIterator_t>)
+	{
+		for_each_range(begin1, end1, [&binaryFunction, begin2, output](InputIterator1_t first, InputIterator1_t last, std::size_t offset)
+			{
+				auto localBegin2 = begin2;
+				std::advance(localBegin2, offset);
+				for (auto localOutput = output + offset; first != last; ++first, ++localBegin2, ++localOutput)
+				{
+					*localOutput = binaryFunction(*first, *localBegin2);
+				}
+			});
+	}
+	else if constexpr (ResizableBackInserter<OutputIterator_t>)
+	{
+		auto &container = back_inserter_container(output);
+		auto oldSize = container.size();
+		container.resize(oldSize + std::distance(begin1, end1));
+		try
+		{
+			transform(begin1, end1, begin2, container.begin() + oldSize, binaryFunction);
+		}
+		catch (...)
+		{
+			container.resize(oldSize);
+			throw;
+		}
+	}
+	else
+	{
+		std::vector<std::pair<InputIterator1_t, InputIterator1_t> > ranges = make_ranges(begin1, end1);
+		auto results = fork_join(ranges, [&binaryFunction, begin1, begin2](const std::pair<InputIterator1_t, InputIterator1_t> &range)
+			{
+				std::vector<BinaryFunctionReturn_t> localResult;
+				localResult.reserve(std::distance(range.first, range.second));
+				auto localBegin2 = begin2;
+				std::advance(localBegin2, std::distance(begin1, range.first));
+				for (auto it = range.first; it != range.second; it++, localBegin2++)
+				{
+					localResult.push_back(binaryFunction(*it, *localBegin2));
+				}
+				return localResult;
+			});
+		for (auto &localResult : results)
+		{
+			for (auto &value : localResult)
+			{
+				if constexpr (std::is_move_assignable_v<BinaryFunctionReturn_t>)
+				{
+					*output++ = std::move(value);
+				}
+				else
+				{
+					*output++ = value;
+				}
+			}
+		}
+	}
+}
+
+template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction, class>
+inline void Threading::transform_non_back_inserter(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction)
+{
+	std::vector<std::pair<InputIterator1_t, InputIterator1_t> > ranges = make_ranges(begin1, end1);
+	fork_join(ranges, [&binaryFunction, begin1, begin2, output](const std::pair<InputIterator1_t, InputIterator1_t> &range)
+		{
+			auto localOutput = output;
+			auto localBegin2 = begin2;
+			std::advance(localBegin2, range.first - begin1);
+			std::advance(localOutput, range.first - begin1);
+			for (auto it = range.first; it != range.second; it++, localBegin2++)
+			{
+				*localOutput++ = binaryFunction(*it, *localBegin2);
+			}
+		});
+}
+
+template <class Function>
+inline void Threading::parallel_for_index(std::size_t size, Function &&function)
+{
+	parallel_for_index(size, partitioner_, function);
+}
+
+template <class Function>
+inline void Threading::parallel_for_index(std::size_t size, const Partitioner &partitioner, Function &&function)
+{
+	auto ranges = partitioner.split(size, pool_->size());
+	fork_join(ranges, [&function](const std::pair<std::size_t, std::size_t> &range)
+		{
+			function(range.first, range.second);
+		});
+}
+
+template <class Iterator_t, class UnaryFunction>
+inline void Threading::for_each(Iterator_t begin, Iterator_t end, UnaryFunction &&unaryFunction)
+{
+	for_each_range(begin, end, [&unaryFunction](Iterator_t first, Iterator_t last, std::size_t)
+		{
+			for (; first != last; ++first)
+			{
+				unaryFunction(*first);
+			}
+		});
+}
+
+template <class Iterator_t, class UnaryFunction>
+inline Iterator_t Threading::for_each_n(Iterator_t begin, std::size_t count, UnaryFunction &&unaryFunction)
+{
+	auto end = std::next(begin, count);
+	for_each(begin, end, unaryFunction);
+	return end;
+}
+
+template <class Iterator_t, class Generator>
+inline void Threading::generate(Iterator_t begin, Iterator_t end, Generator &&generator)
+{
+	for_each_range(begin, end, [&generator](Iterator_t first, Iterator_t last, std::size_t)
+		{
+			for (; first != last; ++first)
+			{
+				*first = generator();
+			}
+		});
+}
+
+template <class Iterator_t, class T>
+inline void Threading::fill(Iterator_t begin, Iterator_t end, const T &value)
+{
+	for_each_range(begin, end, [&value](Iterator_t first, Iterator_t last, std::size_t)
+		{
+			std::fill(first, last, value);
+		});
+}
+
+template <std::integral Index_t, class Body>
+inline void Threading::parallel_for(Index_t beginIndex, Index_t endIndex, Body &&body)
+{
+	if (not (beginIndex < endIndex))
+		return;
+	parallel_for_index(static_cast<std::size_t>(endIndex - beginIndex), [&body, beginIndex](std::size_t first, std::size_t last)
+		{
+			body(BlockedRange<Index_t>(static_cast<Index_t>(beginIndex + first), static_cast<Index_t>(beginIndex + last)));
+		});
+}
+
+template <std::integral Index_t, class Body>
+inline void Threading::parallel_for(Index_t beginIndex, Index_t endIndex, std::size_t grainSize, Body &&body)
+{
+	if (not (beginIndex < endIndex))
+		return;
+	parallel_for_index(static_cast<std::size_t>(endIndex - beginIndex), Partitioner::fixedGrain(grainSize), [&body, beginIndex](std::size_t first, std::size_t last)
+		{
+			body(BlockedRange<Index_t>(static_cast<Index_t>(beginIndex + first), static_cast<Index_t>(beginIndex + last)));
+		});
+}
+
+template <std::size_t Dimensions, class TileFunction>
+inline void Threading::parallel_for_tiles(const std::array<std::size_t, Dimensions> &tileCounts, TileOrder order, TileFunction &&tileFunction)
+{
+	auto sequence = tileSequence(tileCounts, order);
+	parallel_for_index(sequence.size(), Partitioner::guided(1), [&sequence, &tileCounts, &tileFunction](std::size_t first, std::size_t last)
+		{
+			for (auto i = first; i < last; ++i)
+			{
+				std::array<std::size_t, Dimensions> tile;
+				auto rest = sequence[i];
+				for (auto d = Dimensions; d-- > 0;)
+				{
+					tile[d] = rest % tileCounts[d];
+					rest /= tileCounts[d];
+				}
+				tileFunction(tile);
+			}
+		});
+}
+
+template <std::integral Index_t>
+inline BlockedRange<Index_t> Threading::tile_range(BlockedRange<Index_t> range, std::size_t tileSize, std::size_t tile) noexcept
+{
+	auto first = tile * tileSize;
+	return BlockedRange<Index_t>(static_cast<Index_t>(range.begin() + first),
+	                             static_cast<Index_t>(range.begin() + std::min(first + tileSize, range.size())));
+}
+
+template <std::integral Index_t, class Body>
+inline void Threading::parallel_for(BlockedRange2d<Index_t> range, std::size_t rowTile, std::size_t colTile, Body &&body, TileOrder order)
+{
+	if (range.empty())
+		return;
+	rowTile = std::max<std::size_t>(rowTile, 1);
+	colTile = std::max<std::size_t>(colTile, 1);
+	std::array<std::size_t, 2> tileCounts{(range.rows().size() + rowTile - 1) / rowTile, (range.cols().size() + colTile - 1) / colTile};
+	parallel_for_tiles(tileCounts, order, [&body, range, rowTile, colTile](const std::array<std::size_t, 2> &tile)
+		{
+			body(BlockedRange2d<Index_t>(tile_range(range.rows(), rowTile, tile[0]), tile_range(range.cols(), colTile, tile[1])));
+		});
+}
+
+template <std::integral Index_t, class Body>
+inline void Threading::parallel_for(BlockedRange3d<Index_t> range, std::size_t pageTile, std::size_t rowTile, std::size_t colTile, Body &&body, TileOrder order)
+{
+	if (range.empty())
+		return;
+	pageTile = std::max<std::size_t>(pageTile, 1);
+	rowTile = std::max<std::size_t>(rowTile, 1);
+	colTile = std::max<std::size_t>(colTile, 1);
+	std::array<std::size_t, 3> tileCounts{(range.pages().size() + pageTile - 1) / pageTile,
+	                                      (range.rows().size() + rowTile - 1) / rowTile,
+	                                      (range.cols().size() + colTile - 1) / colTile};
+	parallel_for_tiles(tileCounts, order, [&body, range, pageTile, rowTile, colTile](const std::array<std::size_t, 3> &tile)
+		{
+			body(BlockedRange3d<Index_t>(tile_range(range.pages(), pageTile, tile[0]),
+			                             tile_range(range.rows(), rowTile, tile[1]),
+			                             tile_range(range.cols(), colTile, tile[2])));
+		});
+}
+
+template<std::random_access_iterator InputIterator_t, class Comparator>
+inline void Threading::bitonic_sort(InputIterator_t begin, InputIterator_t end, Comparator comparator, SortStability stability)
+{
+	ThreadPool::PriorityScope priorityScope(priority_);
+	auto length = std::distance(begin, end);
+	assert(("Array length must be a power of 2", ((length - 1) & length) == 0));
+	if (length < 2)
+		return;
+
+	IndexSort<InputIterator_t, Comparator> indexSort(begin, end, std::move(comparator), stability);
+	auto &entries = indexSort.entries();
+	using Entry_t = typename IndexSort<InputIterator_t, Comparator>::Entry_t;
+
+	// First half ascending, second half descending, both on the pool.
+	auto ascending = [&indexSort](const Entry_t& lhs, const Entry_t& rhs) { return indexSort.less(lhs, rhs); };
+	auto descending = [&indexSort](const Entry_t& lhs, const Entry_t& rhs) { return indexSort.less(rhs, lhs); };
+	TaskGroup halves(*pool_);
+	halves.run([this, &entries, &ascending, length]()
+		{
+			merge_sort<false>(entries.begin(), entries.begin() + length / 2, ascending, defaultSortGrainSize);
+		});
+	merge_sort<false>(entries.begin() + length / 2, entries.end(), descending, defaultSortGrainSize);
+	halves.wait();
+
+	bitonic_merge(indexSort, 0, entries.size());
+
+	indexSort.scatter([this](std::size_t size, auto &&function) { parallel_for_index(size, function); });
+}
+
+template<class IndexSort_t>
+inline void Threading::bitonic_merge(IndexSort_t& indexSort,
+                                     typename IndexSort_t::size_type low,
+                                     typename IndexSort_t::size_type cnt)
+{
+    if (cnt <= 1)
+        return;
+
+    auto k = cnt / 2;
+    auto &entries = indexSort.entries();
+
+    if (cnt <= bitonicMergeGrainSize)
+    {
+        for (auto i = low; i < low + k; ++i)
+            indexSort.compareExchange(entries[i], entries[i + k]);
+        bitonic_merge(indexSort, low, k);
+        bitonic_merge(indexSort, low + k, k);
+        return;
+    }
+
+    auto ranges = make_ranges(entries.begin() + low, entries.begin() + low + k);
+    fork_join(ranges, [&indexSort, k](const auto &range)
+    {
+        for (auto it = range.first; it != range.second; ++it)
+            indexSort.compareExchange(*it, *(it + k));
+    });
+
+    TaskGroup halves(*pool_);
+    halves.run([this, &indexSort, low, k]()
+    {
+        bitonic_merge(indexSort, low, k);
+    });
+    bitonic_merge(indexSort, low + k, k);
+    halves.wait();
+}
+
+template <std::random_access_iterator InputIterator_t, class Comparator>
+inline void Threading::odd_even_sort(InputIterator_t begin, InputIterator_t end,
+                                     Comparator comparator,
+                                     SortStability stability)
+{
+    ThreadPool::PriorityScope priorityScope(priority_);
+    if (begin == end)
+        return;
+
+    IndexSort<InputIterator_t, Comparator> indexSort(begin, end, std::move(comparator), stability);
+    auto &entries = indexSort.entries();
 
-	template < std::forward_iterator InputIterator_t, class HashFunction = std::hash<::_helpers::IteratorValueType_t<InputIterator_t> >, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
-	void bitonic_sort(InputIterator_t begin, InputIterator_t end, HashFunction hashFunction = HashFunction(), Comparator comparator = Comparator());
+    using size_type = decltype(entries.size());
 
-	template < std::forward_iterator InputIterator_t, class HashFunction = std::hash<::_helpers::IteratorValueType_t<InputIterator_t> >, class Comparator = std::less<::_helpers::IteratorValueType_t<InputIterator_t> > >
-	void odd_even_sort(InputIterator_t begin, InputIterator_t end, HashFunction hashFunction = HashFunction(), Comparator comparator = Comparator());
+    // A phase compare-exchanges the pairs (first + 2p, first + 2p + 1), split over the pairs with partitioner_.
+    auto phase = [this, &entries, &indexSort](size_type first)
+    {
+        auto ranges = partitioner_.split((entries.size() - first) / 2, pool_->size());
+        auto counts = fork_join(ranges, [first, &entries, &indexSort](const std::pair<std::size_t, std::size_t> &range)
+        {
+            size_type localSwapCount = 0;
+            for (auto i = first + 2 * range.first; i < first + 2 * range.second; i += 2)
+            {
+                if (indexSort.compareExchange(entries[i], entries[i + 1]))
+                    localSwapCount++;
+            }
+            return localSwapCount;
+        });
+        size_type swapCount = 0;
+        for (auto count : counts)
+            swapCount += count;
+        return swapCount;
+    };
 
-private:
-	template<class Hash_t, class Value_t, class Comparator>
-	void bitonic_merge(std::vector<Hash_t>& hashValues, std::unordered_multimap<Hash_t, Value_t*>& hashTable, std::vector<Hash_t>::size_type low, std::vector<Hash_t>::size_type cnt, Comparator comparator, ThreadPool& pool);
+    size_type swapCount = 0;
+    do
+    {
+        swapCount = phase(0);
+        swapCount += phase(1);
+    } while (swapCount > 0);
 
-};
+    indexSort.scatter([this](std::size_t size, auto &&function) { parallel_for_index(size, function); });
+}
 
-template <_helpers::AddableIterator Iterator_t>
-inline _helpers::IteratorValueType<Iterator_t>::value_type Threading::reduce(Iterator_t begin, Iterator_t end)
+template <std::random_access_iterator InputIterator_t, class Comparator>
+inline void Threading::sort(InputIterator_t begin, InputIterator_t end, Comparator comparator, std::size_t grainSize)
 {
-	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
-	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<std::optional<value_type> > > results;
-	for (auto i = 0; i < ranges.size(); ++i)
+	merge_sort<false>(begin, end, comparator, grainSize);
+}
+
+template <std::random_access_iterator InputIterator_t, class Comparator>
+inline void Threading::stable_sort(InputIterator_t begin, InputIterator_t end, Comparator comparator, std::size_t grainSize)
+{
+	merge_sort<true>(begin, end, comparator, grainSize);
+}
+
+template <bool Stable, class Iterator_t, class Comparator>
+inline void Threading::merge_sort(Iterator_t begin, Iterator_t end, Comparator &comparator, std::size_t grainSize)
+{
+	ThreadPool::PriorityScope priorityScope(priority_);
+	using value_type = std::iter_value_t<Iterator_t>;
+	std::size_t length = std::distance(begin, end);
+	grainSize = std::max<std::size_t>(grainSize, 2);
+	// Elements are moved into the scratch buffer in parallel chunks, which is only safe if moves cannot throw.
+	if (length <= grainSize or not std::is_nothrow_move_constructible_v<value_type>)
 	{
-		results.push_back(std::async(
-							  [&range=ranges[i]]() -> std::optional<value_type>
-			{
-				auto it = range.first;
-				if (it == range.second)
-				{
-					return std::nullopt;
-				}
-				value_type result = *it++;
-				for (; it != range.second; it++)
-				{
-					result += *it;
-				}
-				return result;
-			}
-							  ));
+		if constexpr (Stable)
+			std::stable_sort(begin, end, comparator);
+		else
+			std::sort(begin, end, comparator);
+		return;
 	}
-	std::optional<value_type> result;
-	for (std::future<std::optional<value_type> > &future : results)
-	{
-		std::optional<value_type> value = future.get();
-		if (value.has_value())
+
+	ScratchBuffer<value_type> buffer(*this, length);
+	parallel_for_index(length, [begin, &buffer](std::size_t first, std::size_t last)
 		{
-			if (result.has_value())
-				*result += std::move(value).value();
-			else
-				result = std::move(value).value();
-		}
-	}
-	if (not result.has_value())
-		throw std::logic_error("Zero values in reduce found");
-	return *result;
+			std::uninitialized_move(begin + first, begin + last, buffer.data + first);
+		});
+	// The buffer holds the values now, sort them back into the range.
+	merge_sort_step<Stable>(buffer.data, begin, 0, length, true, comparator, grainSize);
 }
 
-template <_helpers::AddableIterator Iterator_t>
-inline _helpers::IteratorValueType<Iterator_t>::value_type Threading::reduce(Iterator_t begin, Iterator_t end, IteratorValueType<Iterator_t>::value_type initValue)
+template <bool Stable, class Values_t, class Other_t, class Comparator>
+inline void Threading::merge_sort_step(Values_t values, Other_t other, std::size_t low, std::size_t high, bool resultInOther, Comparator &comparator, std::size_t grainSize)
 {
-	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
-	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<std::optional<value_type> > > results;
-	for (auto i = 0; i < ranges.size(); ++i)
+	if (high - low <= grainSize)
 	{
-		results.push_back(std::async(
-							  [&range=ranges[i]]() -> std::optional<value_type>
-			{
-				auto it = range.first;
-				if (it == range.second)
-				{
-					return std::nullopt;
-				}
-				value_type result = *it++;
-				for (; it != range.second; it++)
-				{
-					result += *it;
-				}
-				return result;
-			}
-							  ));
+		if constexpr (Stable)
+			std::stable_sort(values + low, values + high, comparator);
+		else
+			std::sort(values + low, values + high, comparator);
+		if (resultInOther)
+			std::move(values + low, values + high, other + low);
+		return;
 	}
-	auto result = initValue;
-	for (std::future<std::optional<value_type> > &future : results)
+	auto middle = low + (high - low) / 2;
 	{
-		std::optional<value_type> value = future.get();
-		if(value.has_value())
-			result += std::move(value).value();
+		TaskGroup halves(*pool_);
+		halves.run([this, values, other, low, middle, resultInOther, &comparator, grainSize]()
+			{
+				merge_sort_step<Stable>(values, other, low, middle, not resultInOther, comparator, grainSize);
+			});
+		merge_sort_step<Stable>(values, other, middle, high, not resultInOther, comparator, grainSize);
+		halves.wait();
 	}
-	return result;
+	if (resultInOther)
+		parallel_merge(values, low, middle, middle, high, other, low, comparator, grainSize);
+	else
+		parallel_merge(other, low, middle, middle, high, values, low, comparator, grainSize);
 }
 
-template <class Iterator_t, _helpers::Predicate<typename _helpers::IteratorValueType<Iterator_t>::value_type> Predicate>
-inline Iterator_t Threading::find_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+template <class Input_t, class Output_t, class Comparator>
+inline void Threading::parallel_merge(Input_t input, std::size_t low1, std::size_t high1, std::size_t low2, std::size_t high2, Output_t output, std::size_t outputLow, Comparator &comparator, std::size_t grainSize)
 {
-	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
-	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<std::optional<Iterator_t> > > results;
-	std::atomic_bool found = false;
-	for (auto i = 0; i < ranges.size(); ++i)
+	auto length1 = high1 - low1;
+	auto length2 = high2 - low2;
+	if (length1 + length2 <= grainSize)
 	{
-		const auto &range = ranges[i];
-		results.push_back(std::async(
-							  [&range=range, &found, unaryFunction]() -> std::optional<Iterator_t>
-			{
-				for (auto it = range.first; it != range.second; it++)
-				{
-					if (found)
-						break;
-					if (unaryFunction(*it))
-					{
-						found = true;
-						return it;
-					}
-				}
-				return std::nullopt;
-			}
-							  ));
+		std::merge(std::make_move_iterator(input + low1), std::make_move_iterator(input + high1),
+		           std::make_move_iterator(input + low2), std::make_move_iterator(input + high2),
+		           output + outputLow, comparator);
+		return;
 	}
-	for (std::future<std::optional<Iterator_t> > &localResult : results)
+	// Equal elements of the first run have to stay in front of the equal elements of the second run.
+	std::size_t split1, split2;
+	if (length1 >= length2)
 	{
-		auto optional = localResult.get();
-		if (optional.has_value())
-			return std::move(optional).value();
+		split1 = low1 + length1 / 2;
+		split2 = std::lower_bound(input + low2, input + high2, input[split1], comparator) - input;
 	}
-	return end;
-
+	else
+	{
+		split2 = low2 + length2 / 2;
+		split1 = std::upper_bound(input + low1, input + high1, input[split2], comparator) - input;
+	}
+	auto outputSplit = outputLow + (split1 - low1) + (split2 - low2);
+	TaskGroup halves(*pool_);
+	halves.run([this, input, low1, split1, low2, split2, output, outputLow, &comparator, grainSize]()
+		{
+			parallel_merge(input, low1, split1, low2, split2, output, outputLow, comparator, grainSize);
+		});
+	parallel_merge(input, split1, high1, split2, high2, output, outputSplit, comparator, grainSize);
+	halves.wait();
 }
-template <class Iterator_t, _helpers::Predicate<typename _helpers::IteratorValueType<Iterator_t>::value_type> Predicate>
-inline long long Threading::count_if(Iterator_t begin, Iterator_t end, Predicate &&unaryFunction)
+
+template <class Iterator_t, class KeyFunction>
+requires std::integral<std::remove_cvref_t<std::invoke_result_t<KeyFunction&, std::iter_reference_t<Iterator_t> > > >
+inline std::vector<std::size_t> Threading::histogram(Iterator_t begin, Iterator_t end, std::size_t binCount, KeyFunction &&keyFunction)
 {
-	using Count_t = long long;
-	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
-	std::vector<std::pair<Iterator_t, Iterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<Count_t> > results;
-	for (auto i = 0; i < ranges.size(); ++i)
-	{
-		const auto &range = ranges[i];
-		results.push_back(std::async(
-							  [&range=range, unaryFunction]()
+	ThreadPool::PriorityScope priorityScope(priority_);
+	Combinable<std::vector<std::size_t> > localBins(*pool_, [binCount]() { return std::vector<std::size_t>(binCount); });
+	for_each_range(begin, end, [&localBins, &keyFunction, binCount](Iterator_t first, Iterator_t last, std::size_t)
+		{
+			auto *counts = localBins.local().data();
+			for (; first != last; ++first)
 			{
-				Count_t count = 0;
-				for (auto it = range.first; it != range.second; it++)
+				auto key = keyFunction(*first);
+				if constexpr (std::is_signed_v<decltype(key)>)
 				{
-					if (unaryFunction(*it))
-						count++;
+					if (key < 0)
+						continue;
 				}
-				return count;
+				if (static_cast<std::size_t>(key) < binCount)
+					++counts[static_cast<std::size_t>(key)];
 			}
-							  ));
-	}
-	Count_t count = 0;
-	for (auto &localResult : results)
-		count += localResult.get();
-	return count;
+		});
+	std::vector<const std::size_t *> partials;
+	localBins.combineEach([&partials](const std::vector<std::size_t> &bins) { partials.push_back(bins.data()); });
+	std::vector<std::size_t> result(binCount);
+	auto merge = [&partials, &result](std::size_t first, std::size_t last)
+		{
+			for (const auto *counts : partials)
+			{
+				for (auto bin = first; bin < last; ++bin)
+					result[bin] += counts[bin];
+			}
+		};
+	if (binCount * partials.size() < histogramParallelMergeSize)
+		merge(0, binCount);
+	else
+		parallel_for_index(binCount, merge);
+	return result;
 }
 
-template <class InputIterator_t, class OutputIterator_t, class UnaryFunction, class>
-inline void Threading::transform(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction &&unaryFunction)
+template <std::random_access_iterator Iterator_t>
+requires RadixSortKey<std::iter_value_t<Iterator_t> >
+inline void Threading::radix_sort(Iterator_t begin, Iterator_t end)
 {
-	using InputValue_t = ::_helpers::IteratorValueType<InputIterator_t>::value_type;
-	using UnaryFunctionReturn_t = std::invoke_result_t<UnaryFunction, InputValue_t>;
-	std::vector<std::pair<InputIterator_t, InputIterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<std::vector<UnaryFunctionReturn_t> > > results;
-	try
+	radix_sort(begin, end, std::identity());
+}
+
+template <std::random_access_iterator Iterator_t, class KeyFunction>
+requires RadixSortKey<std::remove_cvref_t<std::invoke_result_t<KeyFunction&, const std::iter_value_t<Iterator_t>&> > >
+inline void Threading::radix_sort(Iterator_t begin, Iterator_t end, KeyFunction keyFunction)
+{
+	ThreadPool::PriorityScope priorityScope(priority_);
+	using value_type = std::iter_value_t<Iterator_t>;
+	auto bitsFunction = [&keyFunction](const value_type &value) { return radix_bits(std::invoke(keyFunction, value)); };
+	using Bits_t = std::invoke_result_t<decltype(bitsFunction)&, const value_type&>;
+	std::size_t length = std::distance(begin, end);
+	// Values are moved in parallel chunks, which is only safe if moves cannot throw.
+	if (length <= radixSortSequentialSize
+	    or not std::is_nothrow_move_constructible_v<value_type> or not std::is_nothrow_move_assignable_v<value_type>)
 	{
+		std::stable_sort(begin, end, [&bitsFunction](const value_type &lhs, const value_type &rhs) { return bitsFunction(lhs) < bitsFunction(rhs); });
+		return;
+	}
 
-		for (auto i = 0; i < ranges.size(); ++i)
-		{
-			results.push_back(std::async([&range = ranges[i], unaryFunction]()
-				{
-					std::vector<UnaryFunctionReturn_t> localResult;
-					for (auto it = range.first; it != range.second; it++)
-					{
-						localResult.push_back(unaryFunction(*it));
-					}
-					return localResult;
-				}));
-		}
+	std::vector<RadixChunk> chunks;
+	for (auto &[first, last] : Partitioner::staticPartition().split(length, pool_->size()))
+		chunks.push_back(RadixChunk{first, last, {}});
+	ScratchBuffer<value_type> buffer(*this, length);
+	// Trivially copyable values are copied into the raw buffer by the first pass, everything else is moved there up front,
+	// as the buffer has to be fully constructed when it is destroyed.
+	bool inBuffer = false;
+	if constexpr (not std::is_trivially_copyable_v<value_type>)
+	{
+		parallel_for_index(length, [begin, &buffer](std::size_t first, std::size_t last)
+			{
+				std::uninitialized_move(begin + first, begin + last, buffer.data + first);
+			});
+		inBuffer = true;
 	}
-	catch(const std::exception &e)
+	for (unsigned shift = 0; shift < sizeof(Bits_t) * 8; shift += radixDigitBits)
 	{
-		throw;
+		bool moved = inBuffer ? radix_pass(buffer.data, begin, chunks, shift, bitsFunction)
+		                      : radix_pass(begin, buffer.data, chunks, shift, bitsFunction);
+		if (moved)
+			inBuffer = not inBuffer;
 	}
-	for (auto &future : results)
+	if (inBuffer)
 	{
-		auto localResult = future.get();
-		for (auto &value : localResult)
-		{
-			if constexpr (std::is_move_assignable_v<UnaryFunctionReturn_t>)
+		parallel_for_index(length, [begin, &buffer](std::size_t first, std::size_t last)
 			{
-				*output++ = std::move(value);
-			}
-			else
-			{
-				*output++ = value;
-			}
-		}
+				std::move(buffer.data + first, buffer.data + last, begin + first);
+			});
 	}
 }
 
-template <class InputIterator_t, class OutputIterator_t, class UnaryFunction, class>
-inline void Threading::transform_non_back_inserter(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction &&unaryFunction)
+template <RadixSortKey Key_t>
+inline auto Threading::radix_bits(Key_t key) noexcept
 {
-	std::vector<std::pair<InputIterator_t, InputIterator_t> > ranges = generateRanges(begin, end, std::thread::hardware_concurrency());
-	std::vector<std::future<void> > tasks;
-	try
+	if constexpr (std::floating_point<Key_t>)
+	{
+		using Bits_t = std::conditional_t<sizeof(Key_t) == 4, std::uint32_t, std::uint64_t>;
+		constexpr Bits_t signBit = Bits_t(1) << (sizeof(Bits_t) * 8 - 1);
+		auto bits = std::bit_cast<Bits_t>(key);
+		// Negative numbers get bigger the bigger their magnitude, so they are flipped entirely.
+		return (bits & signBit) ? Bits_t(~bits) : Bits_t(bits | signBit);
+	}
+	else
+	{
+		using Bits_t = std::make_unsigned_t<Key_t>;
+		if constexpr (std::is_signed_v<Key_t>)
+			return Bits_t(static_cast<Bits_t>(key) ^ (Bits_t(1) << (sizeof(Bits_t) * 8 - 1)));
+		else
+			return static_cast<Bits_t>(key);
+	}
+}
+
+template <class Source_t, class Destination_t, class BitsFunction>
+inline bool Threading::radix_pass(Source_t source, Destination_t destination, std::vector<RadixChunk> &chunks, unsigned shift, BitsFunction &bitsFunction)
+{
+	using value_type = std::iter_value_t<Source_t>;
+	auto digit = [&bitsFunction, shift](const value_type &value)
+		{
+			return static_cast<std::size_t>((bitsFunction(value) >> shift) & (radixBuckets - 1));
+		};
+	fork_join(chunks, [source, &digit](RadixChunk &chunk)
+		{
+			RadixCounts counts{};
+			for (auto i = chunk.first; i < chunk.last; ++i)
+				++counts[digit(source[i])];
+			chunk.offsets = counts;
+		});
+	// Digit by digit, chunk by chunk, so equal digits keep their order.
+	std::size_t length = chunks.back().last, offset = 0;
+	for (std::size_t bucket = 0; bucket < radixBuckets; ++bucket)
 	{
-		for (auto i = 0; i < ranges.size(); ++i)
+		auto bucketBegin = offset;
+		for (auto &chunk : chunks)
 		{
-			tasks.push_back(std::async([&range = ranges[i], unaryFunction, begin, output](){
-					auto localOutput = output;
-					std::advance(localOutput, range.first - begin);
-					for (auto it = range.first; it != range.second; it++)
-					{
-						*localOutput++ = unaryFunction(*it);
-					}
-				}));
+			auto count = chunk.offsets[bucket];
+			chunk.offsets[bucket] = offset;
+			offset += count;
 		}
+		if (offset - bucketBegin == length)
+			return false;
 	}
-	catch(const std::exception &e)
+
+	constexpr std::size_t bufferLength = radixBufferBytes / sizeof(value_type);
+	if constexpr (std::is_trivially_copyable_v<value_type> and bufferLength >= 4)
 	{
-		throw;
+		fork_join(chunks, [source, destination, &digit](RadixChunk &chunk)
+			{
+				auto next = chunk.offsets;
+				auto storage = std::make_unique<std::byte[]>(radixBuckets * bufferLength * sizeof(value_type));
+				std::array<std::size_t, radixBuckets> filled{};
+				auto flush = [destination, &storage, &next, &filled](std::size_t bucket)
+					{
+						const auto *staged = storage.get() + bucket * bufferLength * sizeof(value_type);
+						if constexpr (std::contiguous_iterator<Destination_t>)
+							std::memcpy(std::to_address(destination + next[bucket]), staged, filled[bucket] * sizeof(value_type));
+						else
+						{
+							for (std::size_t i = 0; i < filled[bucket]; ++i)
+								std::memcpy(std::addressof(destination[next[bucket] + i]), staged + i * sizeof(value_type), sizeof(value_type));
+						}
+						next[bucket] += filled[bucket];
+						filled[bucket] = 0;
+					};
+				for (auto i = chunk.first; i < chunk.last; ++i)
+				{
+					const value_type &value = source[i];
+					auto bucket = digit(value);
+					std::memcpy(storage.get() + (bucket * bufferLength + filled[bucket]) * sizeof(value_type), std::addressof(value), sizeof(value_type));
+					if (++filled[bucket] == bufferLength)
+						flush(bucket);
+				}
+				for (std::size_t bucket = 0; bucket < radixBuckets; ++bucket)
+					flush(bucket);
+			});
 	}
-	for (auto &future : tasks)
+	else
 	{
-		future.get();
+		fork_join(chunks, [source, destination, &digit](RadixChunk &chunk)
+			{
+				auto next = chunk.offsets;
+				for (auto i = chunk.first; i < chunk.last; ++i)
+				{
+					auto bucket = digit(source[i]);
+					if constexpr (std::is_trivially_copyable_v<value_type>)
+						std::memcpy(std::addressof(destination[next[bucket]]), std::addressof(source[i]), sizeof(value_type));
+					else
+						destination[next[bucket]] = std::move(source[i]);
+					++next[bucket];
+				}
+			});
 	}
+	return true;
 }
 
-template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction, class>
-inline void Threading::transform(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction)
+template <class Range_t, class Function>
+inline auto Threading::async_fork_join(std::vector<Range_t> ranges, Function function)
 {
-	using InputValue1_t = ::_helpers::IteratorValueType<InputIterator1_t>::value_type;
-	using InputValue2_t = ::_helpers::IteratorValueType<InputIterator2_t>::value_type;
-	using BinaryFunctionReturn_t = std::invoke_result_t<BinaryFunction, InputValue1_t, InputValue2_t>;
-	std::vector<std::pair<InputIterator1_t, InputIterator1_t> > ranges = generateRanges(begin1, end1, std::thread::hardware_concurrency());
-	std::vector<std::future<std::vector<BinaryFunctionReturn_t> > > results;
-	try
+	using Result_t = std::invoke_result_t<Function&, Range_t&>;
+	using Results_t = std::conditional_t<std::is_void_v<Result_t>, void, std::vector<AsyncValue_t<Result_t> > >;
+	// Shared by the chunk tasks, the last one to finish completes the Async.
+	struct Operation
 	{
-		for (auto i = 0; i < ranges.size(); ++i)
+		void fail(std::exception_ptr error) noexcept
 		{
-			results.push_back(std::async([&range = ranges[i], begin1, begin2, binaryFunction](){
-					std::vector<BinaryFunctionReturn_t> localResult;
-					auto localBegin2 = begin2;
-					std::advance(localBegin2, std::distance(range.first, begin1));
-					for (auto it = range.first; it != range.second; it++, localBegin2++)
-					{
-						localResult.push_back(binaryFunction(*it, *localBegin2));
-					}
-					return localResult;
-				}));
+			if (not failed.exchange(true, std::memory_order_relaxed))
+				exception = std::move(error);
 		}
-	}
-	catch(const std::exception &e)
+
+		void finish(std::size_t count) noexcept
+		{
+			if (remaining.fetch_sub(count, std::memory_order_acq_rel) != count)
+				return;
+			try
+			{
+				if (exception)
+					std::rethrow_exception(exception);
+				if constexpr (std::is_void_v<Result_t>)
+					state->setValue();
+				else
+				{
+					Results_t values;
+					values.reserve(results.size());
+					for (auto &result : results)
+						values.push_back(std::move(result).value());
+					state->setValue(std::move(values));
+				}
+			}
+			catch (...)
+			{
+				state->setException(std::current_exception());
+			}
+			state->complete();
+		}
+
+		std::vector<Range_t> ranges;
+		Function function;
+		std::vector<std::optional<AsyncValue_t<Result_t> > > results;
+		std::atomic<std::size_t> remaining;
+		std::atomic<bool> failed = false;
+		std::exception_ptr exception;
+		std::shared_ptr<AsyncState<Results_t> > state = std::make_shared<AsyncState<Results_t> >();
+	};
+
+	auto operation = std::make_shared<Operation>(std::move(ranges), std::move(function));
+	auto count = operation->ranges.size();
+	Async<Results_t> async(operation->state);
+	if constexpr (not std::is_void_v<Result_t>)
+		operation->results.resize(count);
+	operation->remaining.store(std::max<std::size_t>(count, 1), std::memory_order_relaxed);
+	if (count == 0)
 	{
-		throw;
+		operation->finish(1);
+		return async;
 	}
-	for (auto &future : results)
+	ThreadPool::PriorityScope priorityScope(priority_);
+	bool nodeLocal = placement_ == MemoryPlacement::NodeLocal and pool_->nodeCount() > 1;
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		auto localResult = future.get();
-		for (auto &value : localResult)
+		auto task = [operation, i]()
 		{
-			if constexpr (std::is_move_assignable_v<BinaryFunctionReturn_t>)
+			try
 			{
-				*output++ = std::move(value);
+				if constexpr (std::is_void_v<Result_t>)
+					operation->function(operation->ranges[i]);
+				else
+					operation->results[i].emplace(operation->function(operation->ranges[i]));
 			}
-			else
+			catch (...)
 			{
-				*output++ = value;
+				operation->fail(std::current_exception());
 			}
+			operation->finish(1);
+		};
+		try
+		{
+			if (nodeLocal)
+				pool_->submitToNode(i * pool_->nodeCount() / count, std::move(task));
+			else
+				pool_->post(std::move(task));
+		}
+		catch (...)
+		{
+			// The chunks that were not posted count as finished.
+			operation->fail(std::current_exception());
+			operation->finish(count - i);
+			break;
 		}
 	}
+	return async;
 }
 
-template <class InputIterator1_t, class InputIterator2_t, class OutputIterator_t, class BinaryFunction, class>
-inline void Threading::transform_non_back_inserter(InputIterator1_t begin1, InputIterator1_t end1, InputIterator2_t begin2, OutputIterator_t output, BinaryFunction &&binaryFunction)
+template <_helpers::AddableIterator Iterator_t>
+inline Async<typename _helpers::IteratorValueType<Iterator_t>::value_type> Threading::async_reduce(Iterator_t begin, Iterator_t end, typename _helpers::IteratorValueType<Iterator_t>::value_type initValue, FloatSummation summation)
 {
-	std::vector<std::pair<InputIterator1_t, InputIterator1_t> > ranges = generateRanges(begin1, end1, std::thread::hardware_concurrency());
-	std::vector<std::future<void> > tasks;
-	try
-	{
-		for (auto i = 0; i < ranges.size(); ++i)
+	using value_type = _helpers::IteratorValueType<Iterator_t>::value_type;
+	// Kept apart from co_await, GCC 12 destroys temporaries of a co_await full-expression twice.
+	auto chunks = async_fork_join(make_ranges(begin, end), [summation](const std::pair<Iterator_t, Iterator_t> &range) -> std::optional<value_type>
 		{
-			tasks.push_back(std::async([&range = ranges[i], begin1, begin2, output, binaryFunction](){
-					auto localOutput = output;
-					auto localBegin2 = begin2;
-					std::advance(localBegin2, range.first - begin1);
-					std::advance(localOutput, range.first - begin1);
-					for (auto it = range.first; it != range.second; it++, localBegin2++)
-					{
-						*localOutput++ = binaryFunction(*it, *localBegin2);
-					}
-				}));
-		}
-	}
-	catch(const std::exception &e)
+			if (range.first == range.second)
+				return std::nullopt;
+			return sum_range(range.first, range.second, summation);
+		});
+	auto sums = co_await chunks;
+	// Same order of additions as reduce().
+	std::optional<value_type> result;
+	for (auto &sum : sums)
 	{
-		throw;
+		if (not sum.has_value())
+			continue;
+		if (result.has_value())
+			*result += std::move(sum).value();
+		else
+			result = std::move(sum);
 	}
+	if (result.has_value())
+		initValue += std::move(result).value();
+	co_return initValue;
 }
 
-template<std::forward_iterator InputIterator_t, class HashFunction, class Comparator>
-inline void Threading::bitonic_sort(InputIterator_t begin, InputIterator_t end, HashFunction hashFunction, Comparator comparator)
+template <class Iterator_t, class T, class BinaryOperation>
+requires std::invocable<BinaryOperation&, T, T>
+inline Async<T> Threading::async_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation)
 {
-	using value_type = ::_helpers::IteratorValueType_t<InputIterator_t>;
-	using hash_t = std::invoke_result_t<HashFunction, value_type>;
-
-	auto length = std::distance(begin, end);
-	assert(("Array length must be a power of 2", ((length - 1) & length) == 0));
-
-	auto [hashValues, hashTable] = hash_sequence< InputIterator_t, hash_t, value_type >(begin, end, hashFunction, comparator);
+	return async_transform_reduce(begin, end, std::move(initValue), std::move(binaryOperation), std::identity());
+}
 
-	// Verify hashTable construction
-	for (const auto& hash : hashValues) {
-		auto it = hashTable.find(hash);
-		if (it == hashTable.end()) {
-			std::cerr << "Error: Element with hash " << hash << " not found in hashTable!" << std::endl;
-			// Handle error or assert to halt execution
-		}
+template <class Iterator_t, class T, class BinaryOperation, class UnaryTransform>
+inline Async<T> Threading::async_transform_reduce(Iterator_t begin, Iterator_t end, T initValue, BinaryOperation binaryOperation, UnaryTransform unaryTransform)
+{
+	auto chunks = async_fork_join(make_ranges(begin, end), [binaryOperation, unaryTransform](const std::pair<Iterator_t, Iterator_t> &range) -> std::optional<T>
+		{
+			if (range.first == range.second)
+				return std::nullopt;
+			auto first = range.first;
+			T result = unaryTransform(*first);
+			for (++first; first != range.second; ++first)
+				result = binaryOperation(std::move(result), unaryTransform(*first));
+			return result;
+		});
+	auto partials = co_await chunks;
+	std::optional<T> result;
+	for (auto &partial : partials)
+	{
+		if (not partial.has_value())
+			continue;
+		if (result.has_value())
+			result.emplace(binaryOperation(std::move(result).value(), std::move(partial).value()));
+		else
+			result = std::move(partial);
 	}
+	if (result.has_value())
+		co_return binaryOperation(std::move(initValue), std::move(result).value());
+	co_return initValue;
+}
 
-	// Sort first half in ascending order
-	std::sort(std::execution::par_unseq, hashValues.begin(), hashValues.begin() + (length / 2),
-	          [&hashTable, &comparator](const hash_t& lhs, const hash_t& rhs)
+template <class Iterator_t, class Predicate>
+inline Async<long long> Threading::async_count_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction)
+{
+	auto chunks = async_fork_join(make_ranges(begin, end), [unaryFunction](const std::pair<Iterator_t, Iterator_t> &range) mutable
 		{
-			if (lhs == rhs)
-				return false;
-			return comparator(*hashTable.find(lhs)->second, *hashTable.find(rhs)->second);
+			return count_range(range.first, range.second, unaryFunction);
 		});
+	auto counts = co_await chunks;
+	long long count = 0;
+	for (auto localCount : counts)
+		count += localCount;
+	co_return count;
+}
 
-	// Sort second half in descending order
-	std::sort(std::execution::par_unseq, hashValues.begin() + length / 2, hashValues.end(),
-	          [&hashTable, &comparator](hash_t lhs, hash_t rhs)
+template <class Iterator_t, class Predicate>
+inline Async<Iterator_t> Threading::async_find_if(Iterator_t begin, Iterator_t end, Predicate unaryFunction)
+{
+	auto length = static_cast<std::size_t>(std::distance(begin, end));
+	auto best = std::make_shared<std::atomic<std::size_t> >(length);
+	auto chunks = async_fork_join(make_ranges(begin, end), [unaryFunction, best, begin](const std::pair<Iterator_t, Iterator_t> &range) mutable
 		{
-			if (lhs == rhs)
-				return false;
-			return not comparator(*hashTable.find(lhs)->second, *hashTable.find(rhs)->second);
+			std::size_t index = std::distance(begin, range.first);
+			auto it = range.first;
+			// Like find_if(), chunks right of a known match stop at the next block.
+			while (it != range.second and best->load(std::memory_order_relaxed) > index)
+			{
+				for (std::size_t scanned = 0; scanned < findBlockSize and it != range.second; ++scanned, ++it, ++index)
+				{
+					if (unaryFunction(*it))
+					{
+						auto current = best->load(std::memory_order_relaxed);
+						while (index < current and not best->compare_exchange_weak(current, index, std::memory_order_relaxed))
+						{ }
+						return;
+					}
+				}
+			}
 		});
-
-	{
-		ThreadPool pool(12);
-		bitonic_merge(hashValues, hashTable, 0, hashValues.size(), comparator, pool);
-	}
-
-	placeElementsInCorrectPositions(begin, end, hashFunction, hashValues, hashTable);
+	co_await chunks;
+	co_return std::next(begin, best->load(std::memory_order_relaxed));
 }
 
-template<class Hash_t, class Value_t, class Comparator>
-inline void Threading::bitonic_merge(std::vector<Hash_t>& hashValues,
-                                     std::unordered_multimap<Hash_t, Value_t*>& hashTable,
-                                     std::vector<Hash_t>::size_type low,
-                                     std::vector<Hash_t>::size_type cnt,
-                                     Comparator comparator,
-                                     ThreadPool& pool)
+template <std::random_access_iterator InputIterator_t, std::random_access_iterator OutputIterator_t, class UnaryFunction>
+inline Async<OutputIterator_t> Threading::async_transform(InputIterator_t begin, InputIterator_t end, OutputIterator_t output, UnaryFunction unaryFunction)
 {
-    if (cnt <= 1)
-        return;
-
-    auto k = cnt / 2;
-    auto inplaceComparator = createInplaceComparator(comparator, hashTable);
-
-    size_t numThreads = std::thread::hardware_concurrency();
-    size_t chunkSize = (k + numThreads - 1) / numThreads;
-
-    std::vector<std::future<void>> results;
-    results.reserve(numThreads);
-
-    for (size_t chunkStart = low; chunkStart < low + k; chunkStart += chunkSize)
-    {
-        results.push_back(pool.submit([chunkStart, chunkSize, &hashValues, k, &inplaceComparator, low]()
-        {
-            for (size_t i = chunkStart; i < std::min(chunkStart + chunkSize, low + k); ++i)
-            {
-                inplaceComparator(hashValues[i], hashValues[i + k]);
-            }
-        }));
-    }
-
-    for (auto& result : results)
-    {
-        result.get();
-    }
-
-    bitonic_merge(hashValues, hashTable, low, k, comparator, pool);
-    bitonic_merge(hashValues, hashTable, low + k, k, comparator, pool);
+	auto chunks = async_fork_join(make_ranges(begin, end), [unaryFunction, begin, output](const std::pair<InputIterator_t, InputIterator_t> &range) mutable
+		{
+			std::transform(range.first, range.second, output + (range.first - begin), unaryFunction);
+		});
+	co_await chunks;
+	co_return output + (end - begin);
 }
 
-template <std::forward_iterator InputIterator_t, class HashFunction, class Comparator>
-inline void Threading::odd_even_sort(InputIterator_t begin, InputIterator_t end,
-                                     HashFunction hashFunction,
-                                     Comparator comparator)
+template <class Iterator_t, class UnaryFunction>
+inline Async<void> Threading::async_for_each(Iterator_t begin, Iterator_t end, UnaryFunction unaryFunction)
 {
-    using value_type = ::_helpers::IteratorValueType_t<InputIterator_t>;
-    using hash_t = std::invoke_result_t<HashFunction, value_type>;
-
-    if (begin == end)
-        return;
-
-    auto [hashValues, hashTable] = hash_sequence< InputIterator_t, hash_t, value_type >(begin, end, hashFunction, comparator);
-
-    using size_type = decltype(hashValues.size());
-    size_type swapCount = 0;
-    auto inplaceComparator = createInplaceComparator(comparator, hashTable);
-
-    ThreadPool pool(std::thread::hardware_concurrency());
-    size_t numThreads = std::thread::hardware_concurrency();
-    size_t chunkSize = (hashValues.size() + numThreads - 1) / numThreads;
-
-    do
-    {
-        swapCount = 0;
-        std::vector<std::future<size_type>> results;
-
-        for (size_t chunkStart = 1; chunkStart < hashValues.size(); chunkStart += 2 * chunkSize)
-        {
-            results.push_back(pool.submit([chunkStart, chunkSize, &hashValues, &inplaceComparator]()
-            {
-                size_type localSwapCount = 0;
-                for (size_t i = chunkStart; i < std::min(chunkStart + 2*chunkSize, hashValues.size()); i += 2)
-                {
-                    if (i < hashValues.size() && inplaceComparator(hashValues[i - 1], hashValues[i]))
-                    {
-                        localSwapCount++;
-                    }
-                }
-                return localSwapCount;
-            }));
-        }
-
-        for (auto &result : results)
-            swapCount += result.get();
-
-        results.clear();
-
-        for (size_t chunkStart = 2; chunkStart < hashValues.size(); chunkStart += 2 * chunkSize)
-        {
-            results.push_back(pool.submit([chunkStart, chunkSize, &hashValues, &inplaceComparator]()
-            {
-                size_type localSwapCount = 0;
-                for (size_t i = chunkStart; i < std::min(chunkStart + 2*chunkSize, hashValues.size()); i += 2)
-                {
-                    if (i < hashValues.size() && inplaceComparator(hashValues[i - 1], hashValues[i]))
-                    {
-                        localSwapCount++;
-                    }
-                }
-                return localSwapCount;
-            }));
-        }
-
-        for (auto &result : results)
-            swapCount += result.get();
-
-        results.clear();
-    } while (swapCount > 0);
+	return async_fork_join(make_ranges(begin, end), [unaryFunction](const std::pair<Iterator_t, Iterator_t> &range) mutable
+		{
+			std::for_each(range.first, range.second, unaryFunction);
+		});
+}
 
-    placeElementsInCorrectPositions(begin, end, hashFunction, hashValues, hashTable);
+template <class Function>
+inline Async<std::invoke_result_t<Function&, Threading&> > Threading::async_invoke(Function function)
+{
+	using Result_t = std::invoke_result_t<Function&, Threading&>;
+	auto state = std::make_shared<AsyncState<Result_t> >();
+	ThreadPool::PriorityScope priorityScope(priority_);
+	pool_->post([state, function = std::move(function), threading = *this]() mutable
+		{
+			try
+			{
+				if constexpr (std::is_void_v<Result_t>)
+				{
+					function(threading);
+					state->setValue();
+				}
+				else
+					state->setValue(function(threading));
+			}
+			catch (...)
+			{
+				state->setException(std::current_exception());
+			}
+			state->complete();
+		});
+	return Async<Result_t>(std::move(state));
 }
 
 } // namespace s0m4b0dY
@@ -0,0 +1,76 @@
+#ifndef S0_PARTITIONER_HPP
+#define S0_PARTITIONER_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief Decides how Threading algorithms split their input into chunks.
+     * Every chunk becomes one pool task, the first one runs on the calling thread.
+     */
+    class Partitioner
+    {
+    public:
+        enum class Kind
+        {
+            /**
+             * @brief One equal chunk per worker.
+             */
+            Static,
+            /**
+             * @brief Chunks of exactly grainSize() elements, the last one may be shorter.
+             */
+            FixedGrain,
+            /**
+             * @brief Every chunk takes remaining / workers elements, but at least grainSize().
+             * Big chunks first, small ones at the end to even out the finish.
+             */
+            Guided,
+            /**
+             * @brief Sequential below sequentialThreshold(), otherwise chunksPerWorker() chunks per worker
+             * of at least grainSize() elements, so idle workers can steal the rest of a slow chunk's share.
+             */
+            Auto
+        };
+
+        static constexpr std::size_t defaultSequentialThreshold = 1 << 12;
+        static constexpr std::size_t defaultChunksPerWorker = 4;
+        static constexpr std::size_t defaultGrainSize = 1 << 10;
+
+        /**
+         * @brief Same as automatic().
+         */
+        Partitioner() noexcept;
+
+        static Partitioner staticPartition() noexcept;
+        static Partitioner fixedGrain(std::size_t grainSize) noexcept;
+        static Partitioner guided(std::size_t minGrainSize = 1) noexcept;
+        static Partitioner automatic(std::size_t sequentialThreshold = defaultSequentialThreshold,
+                                     std::size_t chunksPerWorker = defaultChunksPerWorker,
+                                     std::size_t minGrainSize = defaultGrainSize) noexcept;
+
+        Kind kind() const noexcept;
+        std::size_t grainSize() const noexcept;
+        std::size_t sequentialThreshold() const noexcept;
+        std::size_t chunksPerWorker() const noexcept;
+
+        /**
+         * @brief Splits [0, size) into consecutive non empty chunks for @p workers workers.
+         * @return No chunks for an empty range.
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> split(std::size_t size, std::size_t workers) const;
+
+    private:
+        Partitioner(Kind kind, std::size_t grainSize, std::size_t sequentialThreshold, std::size_t chunksPerWorker) noexcept;
+
+        Kind kind_;
+        std::size_t grainSize_;
+        std::size_t sequentialThreshold_;
+        std::size_t chunksPerWorker_;
+    };
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef S0_PIPELINE_HPP
+#define S0_PIPELINE_HPP
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s0_parallel_algorithms_threading.hpp"
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief First stage of every Pipeline, passes the input elements on unchanged.
+     */
+    struct PipelineSource
+    {
+        template <class Sink>
+        Sink bind(Sink sink) const
+        {
+            return sink;
+        }
+    };
+
+    template <class Previous_t, class Function>
+    struct TransformStage
+    {
+        /**
+         * @brief Sink that feeds function(value) to @p sink.
+         */
+        template <class Sink>
+        auto bind(Sink sink) const
+        {
+            return previous.bind([&function = function, sink = std::move(sink)](auto &&value) mutable
+                {
+                    sink(std::invoke(function, std::forward<decltype(value)>(value)));
+                });
+        }
+
+        Previous_t previous;
+        Function function;
+    };
+
+    template <class Previous_t, class Predicate>
+    struct FilterStage
+    {
+        /**
+         * @brief Sink that feeds the values satisfying predicate to @p sink.
+         */
+        template <class Sink>
+        auto bind(Sink sink) const
+        {
+            return previous.bind([&predicate = predicate, sink = std::move(sink)](auto &&value) mutable
+                {
+                    if (std::invoke(predicate, std::as_const(value)))
+                        sink(std::forward<decltype(value)>(value));
+                });
+        }
+
+        Previous_t previous;
+        Predicate predicate;
+    };
+
+    /**
+     * @brief Lazy chain of transform() and filter() stages over [begin, end), run by a terminal operation.
+     * The terminal operation splits the input like every Threading algorithm and pushes each element through
+     * all stages before it reads the next one. Intermediate values never leave the chunk, the input is read once.
+     * Stage functions are called concurrently and must outlive the terminal operation.
+     *
+     * @code
+     * auto sumOfOddSquares = pipeline(threading, values)
+     *     .transform([](int value) { return value * value; })
+     *     .filter([](int square) { return square % 2 != 0; })
+     *     .reduce(0LL);
+     * @endcode
+     */
+    template <class Iterator_t, class Stages_t = PipelineSource>
+    class Pipeline
+    {
+    public:
+        /**
+         * @param owner Kept alive as long as the pipeline, for ranges the iterators point into.
+         */
+        Pipeline(Threading &threading, Iterator_t begin, Iterator_t end, Stages_t stages = Stages_t(), std::shared_ptr<const void> owner = nullptr);
+
+        template <class Function>
+        Pipeline<Iterator_t, TransformStage<Stages_t, Function>> transform(Function function) const;
+
+        template <class Predicate>
+        Pipeline<Iterator_t, FilterStage<Stages_t, Predicate>> filter(Predicate predicate) const;
+
+        /**
+         * @brief Folds the values reaching the end of the pipeline, chunk results are combined in input order.
+         * @p binaryOperation has to be associative, like for Threading::reduce().
+         */
+        template <class T, class BinaryOperation = std::plus<>>
+        T reduce(T initValue, BinaryOperation binaryOperation = BinaryOperation()) const;
+
+        /**
+         * @return Number of values passing every filter().
+         */
+        long long count() const;
+
+        /**
+         * @brief Calls unaryFunction(value) for every value reaching the end of the pipeline, concurrently.
+         */
+        template <class UnaryFunction>
+        void for_each(UnaryFunction unaryFunction) const;
+
+    private:
+        /**
+         * @brief Calls chunkFunction(feed) for every chunk, feed(sink) pushes the chunk through the stages into sink.
+         * @return What chunkFunction returns per chunk, in input order.
+         */
+        template <class ChunkFunction>
+        auto run(ChunkFunction &&chunkFunction) const;
+
+        Threading &threading_;
+        Iterator_t begin_;
+        Iterator_t end_;
+        Stages_t stages_;
+        std::shared_ptr<const void> owner_;
+    };
+
+    template <class Iterator_t>
+    Pipeline<Iterator_t> pipeline(Threading &threading, Iterator_t begin, Iterator_t end);
+
+    /**
+     * @brief Pipeline over a random access range, e.g. a container or std::views::iota / std::views::transform of one.
+     * Lvalue ranges are referenced and have to outlive the terminal operation. Temporaries that are not borrowed ranges,
+     * like a std::vector or a std::views::transform view, are moved into the pipeline.
+     * Views that are not random access, like std::views::filter, cannot be split, use Pipeline::filter() instead.
+     */
+    template <std::ranges::random_access_range Range_t>
+    requires std::ranges::sized_range<Range_t> and std::ranges::viewable_range<Range_t>
+    auto pipeline(Threading &threading, Range_t &&range);
+
+    template <class Iterator_t, class Stages_t>
+    inline Pipeline<Iterator_t, Stages_t>::Pipeline(Threading &threading, Iterator_t begin, Iterator_t end, Stages_t stages, std::shared_ptr<const void> owner)
+        : threading_(threading),
+          begin_(std::move(begin)),
+          end_(std::move(end)),
+          stages_(std::move(stages)),
+          owner_(std::move(owner))
+    { }
+
+    template <class Iterator_t, class Stages_t>
+    template <class Function>
+    inline Pipeline<Iterator_t, TransformStage<Stages_t, Function>> Pipeline<Iterator_t, Stages_t>::transform(Function function) const
+    {
+        return {threading_, begin_, end_, TransformStage<Stages_t, Function>{stages_, std::move(function)}, owner_};
+    }
+
+    template <class Iterator_t, class Stages_t>
+    template <class Predicate>
+    inline Pipeline<Iterator_t, FilterStage<Stages_t, Predicate>> Pipeline<Iterator_t, Stages_t>::filter(Predicate predicate) const
+    {
+        return {threading_, begin_, end_, FilterStage<Stages_t, Predicate>{stages_, std::move(predicate)}, owner_};
+    }
+
+    template <class Iterator_t, class Stages_t>
+    template <class ChunkFunction>
+    inline auto Pipeline<Iterator_t, Stages_t>::run(ChunkFunction &&chunkFunction) const
+    {
+        auto ranges = threading_.make_ranges(begin_, end_);
+        return threading_.fork_join(ranges, [this, &chunkFunction](const std::pair<Iterator_t, Iterator_t> &range)
+            {
+                return chunkFunction([this, &range](auto &&sink)
+                    {
+                        auto bound = stages_.bind([&sink](auto &&value) { sink(std::forward<decltype(value)>(value)); });
+                        for (auto it = range.first; it != range.second; ++it)
+                            bound(*it);
+                    });
+            });
+    }
+
+    template <class Iterator_t, class Stages_t>
+    template <class T, class BinaryOperation>
+    inline T Pipeline<Iterator_t, Stages_t>::reduce(T initValue, BinaryOperation binaryOperation) const
+    {
+        auto partials = run([&binaryOperation](auto &&feed)
+            {
+                std::optional<T> partial;
+                feed([&binaryOperation, &partial](auto &&value)
+                    {
+                        if (partial.has_value())
+                            *partial = binaryOperation(std::move(*partial), std::forward<decltype(value)>(value));
+                        else
+                            partial.emplace(std::forward<decltype(value)>(value));
+                    });
+                return partial;
+            });
+        for (auto &partial : partials)
+        {
+            if (partial.has_value())
+                initValue = binaryOperation(std::move(initValue), std::move(partial).value());
+        }
+        return initValue;
+    }
+
+    template <class Iterator_t, class Stages_t>
+    inline long long Pipeline<Iterator_t, Stages_t>::count() const
+    {
+        auto counts = run([](auto &&feed)
+            {
+                long long count = 0;
+                feed([&count](auto &&) { ++count; });
+                return count;
+            });
+        long long count = 0;
+        for (auto localCount : counts)
+            count += localCount;
+        return count;
+    }
+
+    template <class Iterator_t, class Stages_t>
+    template <class UnaryFunction>
+    inline void Pipeline<Iterator_t, Stages_t>::for_each(UnaryFunction unaryFunction) const
+    {
+        run([&unaryFunction](auto &&feed)
+            {
+                feed([&unaryFunction](auto &&value) { std::invoke(unaryFunction, std::forward<decltype(value)>(value)); });
+            });
+    }
+
+    template <class Iterator_t>
+    inline Pipeline<Iterator_t> pipeline(Threading &threading, Iterator_t begin, Iterator_t end)
+    {
+        return Pipeline<Iterator_t>(threading, std::move(begin), std::move(end));
+    }
+
+    template <std::ranges::random_access_range Range_t>
+    requires std::ranges::sized_range<Range_t> and std::ranges::viewable_range<Range_t>
+    inline auto pipeline(Threading &threading, Range_t &&range)
+    {
+        // begin() + size() instead of end(), which may be a sentinel of another type.
+        if constexpr (std::ranges::borrowed_range<Range_t>)
+        {
+            auto begin = std::ranges::begin(range);
+            return Pipeline<decltype(begin)>(threading, begin, begin + std::ranges::distance(range));
+        }
+        else
+        {
+            // Held through a shared_ptr, so the iterators stay valid when the pipeline is copied.
+            auto view = std::make_shared<std::views::all_t<Range_t>>(std::views::all(std::forward<Range_t>(range)));
+            auto begin = std::ranges::begin(*view);
+            return Pipeline<decltype(begin)>(threading, begin, begin + std::ranges::distance(*view), PipelineSource(), view);
+        }
+    }
+}
+
+#endif
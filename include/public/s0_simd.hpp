@@ -0,0 +1,82 @@
+#ifndef S0_SIMD_HPP
+#define S0_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief How floating point ranges are summed inside one chunk.
+     */
+    enum class FloatSummation
+    {
+        /**
+         * @brief Left to right, like std::accumulate. Bound by the add latency chain.
+         */
+        Ordered,
+        /**
+         * @brief Independent vector accumulators. Fastest, the rounding differs from Ordered.
+         */
+        Reassociate,
+        /**
+         * @brief Pairwise summation on top of the vector kernel. Error grows with log(n) instead of n.
+         */
+        Pairwise
+    };
+
+    namespace simd
+    {
+        enum class Isa
+        {
+            Scalar,
+            Avx2,
+            Avx512
+        };
+
+        /**
+         * @brief Best instruction set supported by the running CPU.
+         */
+        Isa supportedIsa() noexcept;
+
+        /**
+         * @brief Instruction set used by the kernels. supportedIsa() unless changed by setActiveIsa().
+         */
+        Isa activeIsa() noexcept;
+
+        /**
+         * @brief Restricts the kernels to @p isa, clamped to supportedIsa(). Meant for tests and benchmarks.
+         */
+        void setActiveIsa(Isa isa) noexcept;
+
+        template < class T >
+        inline constexpr bool isSummable = std::is_same_v<T, std::int32_t> or std::is_same_v<T, std::uint32_t>
+                                           or std::is_same_v<T, std::int64_t> or std::is_same_v<T, std::uint64_t>
+                                           or std::is_same_v<T, long long> or std::is_same_v<T, unsigned long long>
+                                           or std::is_same_v<T, float> or std::is_same_v<T, double>;
+
+        /**
+         * @brief Sum with several independent accumulators. Integers wrap around on overflow.
+         */
+        std::int32_t sum(const std::int32_t *data, std::size_t size) noexcept;
+        std::uint32_t sum(const std::uint32_t *data, std::size_t size) noexcept;
+        std::int64_t sum(const std::int64_t *data, std::size_t size) noexcept;
+        std::uint64_t sum(const std::uint64_t *data, std::size_t size) noexcept;
+
+        /**
+         * @brief long long and unsigned long long, distinct types from std::int64_t and std::uint64_t where those are long.
+         * Where they are the same type the non template overloads above are picked.
+         */
+        template < class T >
+        requires std::is_same_v<T, long long> or std::is_same_v<T, unsigned long long>
+        T sum(const T *data, std::size_t size) noexcept;
+        float sum(const float *data, std::size_t size) noexcept;
+        double sum(const double *data, std::size_t size) noexcept;
+
+        float pairwise_sum(const float *data, std::size_t size) noexcept;
+        double pairwise_sum(const double *data, std::size_t size) noexcept;
+    }
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef S0_SMALL_OBJECT_POOL_HPP
+#define S0_SMALL_OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <new>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief Size class free lists for the small, short lived objects of the task path
+     * (task nodes, promise/future shared states, oversized task callables).
+     * Every thread keeps a small cache per size class and exchanges batches with a global list,
+     * so blocks freed on another thread are reused instead of returned to the heap.
+     * Requests above maxSize go straight to operator new.
+     */
+    class SmallObjectPool
+    {
+    public:
+        static constexpr std::size_t granularity = 16;
+        static constexpr std::size_t maxSize = 512;
+
+        static void *allocate(std::size_t size);
+        static void deallocate(void *pointer, std::size_t size) noexcept;
+    };
+
+    /**
+     * @brief Standard allocator on top of SmallObjectPool.
+     */
+    template < class T >
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template < class U >
+        PoolAllocator(const PoolAllocator<U> &) noexcept
+        { }
+
+        T *allocate(std::size_t n);
+        void deallocate(T *pointer, std::size_t n) noexcept;
+
+        template < class U >
+        bool operator==(const PoolAllocator<U> &) const noexcept
+        {
+            return true;
+        }
+    };
+
+    template <class T>
+    inline T *PoolAllocator<T>::allocate(std::size_t n)
+    {
+        if constexpr (alignof(T) > SmallObjectPool::granularity)
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        else
+            return static_cast<T *>(SmallObjectPool::allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void PoolAllocator<T>::deallocate(T *pointer, std::size_t n) noexcept
+    {
+        if constexpr (alignof(T) > SmallObjectPool::granularity)
+            ::operator delete(pointer, n * sizeof(T), std::align_val_t(alignof(T)));
+        else
+            SmallObjectPool::deallocate(pointer, n * sizeof(T));
+    }
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef S0_TASK_HPP
+#define S0_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "s0_small_object_pool.hpp"
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief Move only replacement of std::function<void()> for pool tasks.
+     * Callables up to inlineSize bytes with a noexcept move constructor are stored inline,
+     * bigger ones go to SmallObjectPool.
+     */
+    class Task
+    {
+    public:
+        static constexpr std::size_t inlineSize = 48;
+
+        Task() noexcept = default;
+
+        template < class Fn, class = std::enable_if_t<not std::is_same_v<std::decay_t<Fn>, Task>> >
+        Task(Fn &&func);
+
+        Task(Task &&other) noexcept;
+        Task &operator=(Task &&other) noexcept;
+        ~Task();
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        void operator()();
+
+        explicit operator bool() const noexcept;
+
+    private:
+        struct Operations
+        {
+            void (*invoke)(void *storage);
+            void (*relocate)(void *from, void *to) noexcept;
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template < class Fn >
+        static constexpr bool storedInline = sizeof(Fn) <= inlineSize
+                                             and alignof(Fn) <= alignof(std::max_align_t)
+                                             and std::is_nothrow_move_constructible_v<Fn>;
+
+        template < class Fn >
+        static const Operations inlineOperations;
+
+        template < class Fn >
+        static const Operations pooledOperations;
+
+        void reset() noexcept;
+
+        alignas(std::max_align_t) unsigned char storage_[inlineSize];
+        const Operations *operations_ = nullptr;
+    };
+
+    template <class Fn>
+    inline const Task::Operations Task::inlineOperations = {
+        [](void *storage) { (*std::launder(static_cast<Fn *>(storage)))(); },
+        [](void *from, void *to) noexcept {
+            Fn *source = std::launder(static_cast<Fn *>(from));
+            ::new (to) Fn(std::move(*source));
+            source->~Fn();
+        },
+        [](void *storage) noexcept { std::launder(static_cast<Fn *>(storage))->~Fn(); }
+    };
+
+    template <class Fn>
+    inline const Task::Operations Task::pooledOperations = {
+        [](void *storage) { (**static_cast<Fn **>(storage))(); },
+        [](void *from, void *to) noexcept { ::new (to) Fn *(*static_cast<Fn **>(from)); },
+        [](void *storage) noexcept {
+            Fn *func = *static_cast<Fn **>(storage);
+            func->~Fn();
+            if constexpr (alignof(Fn) > SmallObjectPool::granularity)
+                ::operator delete(func, sizeof(Fn), std::align_val_t(alignof(Fn)));
+            else
+                SmallObjectPool::deallocate(func, sizeof(Fn));
+        }
+    };
+
+    template <class Fn, class>
+    inline Task::Task(Fn &&func)
+    {
+        using Func_t = std::decay_t<Fn>;
+        if constexpr (storedInline<Func_t>)
+        {
+            ::new (static_cast<void *>(storage_)) Func_t(std::forward<Fn>(func));
+            operations_ = &inlineOperations<Func_t>;
+        }
+        else
+        {
+            void *memory;
+            if constexpr (alignof(Func_t) > SmallObjectPool::granularity)
+                memory = ::operator new(sizeof(Func_t), std::align_val_t(alignof(Func_t)));
+            else
+                memory = SmallObjectPool::allocate(sizeof(Func_t));
+            try
+            {
+                ::new (static_cast<void *>(storage_)) Func_t *(::new (memory) Func_t(std::forward<Fn>(func)));
+            }
+            catch (...)
+            {
+                if constexpr (alignof(Func_t) > SmallObjectPool::granularity)
+                    ::operator delete(memory, sizeof(Func_t), std::align_val_t(alignof(Func_t)));
+                else
+                    SmallObjectPool::deallocate(memory, sizeof(Func_t));
+                throw;
+            }
+            operations_ = &pooledOperations<Func_t>;
+        }
+    }
+
+    inline Task::Task(Task &&other) noexcept
+        : operations_(other.operations_)
+    {
+        if (operations_ != nullptr)
+        {
+            operations_->relocate(other.storage_, storage_);
+            other.operations_ = nullptr;
+        }
+    }
+
+    inline Task &Task::operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            operations_ = other.operations_;
+            if (operations_ != nullptr)
+            {
+                operations_->relocate(other.storage_, storage_);
+                other.operations_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    inline Task::~Task()
+    {
+        reset();
+    }
+
+    inline void Task::operator()()
+    {
+        operations_->invoke(storage_);
+    }
+
+    inline Task::operator bool() const noexcept
+    {
+        return operations_ != nullptr;
+    }
+
+    inline void Task::reset() noexcept
+    {
+        if (operations_ != nullptr)
+        {
+            operations_->destroy(storage_);
+            operations_ = nullptr;
+        }
+    }
+}
+
+#endif
@@ -5,61 +5,651 @@
 #include <memory>
 #include <thread>
 #include <future>
+#include <functional>
+#include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <array>
 #include <boost/thread/concurrent_queues/sync_queue.hpp>
 
+#include "s0_work_stealing_deque.hpp"
+#include "s0_small_object_pool.hpp"
+#include "s0_task.hpp"
+#include "s0_topology.hpp"
+
 namespace s0m4b0dY
 {
     class ThreadPool
     {
-        using Task_t = std::function<void()>;
-        using Queue_t = boost::sync_queue<Task_t>;
+        using Task_t = Task;
+
+        struct QueuedTask
+        {
+            Task_t task;
+#ifdef S0_THREAD_POOL_METRICS
+            std::chrono::steady_clock::time_point enqueued = std::chrono::steady_clock::now();
+#endif
+        };
+
+        using Queue_t = boost::sync_queue<QueuedTask>;
     public:
-        ThreadPool(int nThreads);
+        /**
+         * @brief Idle workers always take the most urgent queued task first, so high priority calls
+         * overtake background work at chunk granularity. Running tasks are never interrupted.
+         */
+        enum class Priority
+        {
+            High,
+            Normal,
+            Low
+        };
+
+        static constexpr std::size_t priorityCount = 3;
+
+        /**
+         * @brief One in lowPriorityShare picks of a worker scans the levels bottom up, so busy high levels do not starve the low ones.
+         */
+        static constexpr std::uint32_t lowPriorityShare = 32;
+
+        /**
+         * @brief Sets the priority of the tasks the current thread submits, restored on destruction.
+         * Tasks run with the priority they were submitted with and pass it on to the tasks they submit.
+         */
+        class PriorityScope
+        {
+        public:
+            explicit PriorityScope(Priority priority) noexcept;
+            ~PriorityScope();
+
+            PriorityScope(const PriorityScope &) = delete;
+            PriorityScope &operator=(const PriorityScope &) = delete;
+
+        private:
+            Priority previous_;
+        };
+
+        /**
+         * @return Priority submissions of the calling thread get, Priority::Normal outside of tasks and scopes.
+         */
+        static Priority currentPriority() noexcept;
+
+        /**
+         * @brief True if built with S0_THREAD_POOL_METRICS. Otherwise the pool does not record anything
+         * and metrics() only reports the queue depth.
+         */
+#ifdef S0_THREAD_POOL_METRICS
+        static constexpr bool metricsEnabled = true;
+#else
+        static constexpr bool metricsEnabled = false;
+#endif
+
+        /**
+         * @brief Histogram with power of two buckets, bucket i counts durations in [2^(i-1), 2^i) nanoseconds.
+         * The last bucket also takes everything longer.
+         */
+        struct Histogram
+        {
+            static constexpr std::size_t bucketCount = 36;
+
+            std::uint64_t count() const noexcept;
+
+            /**
+             * @return Upper bound of the bucket holding the @p fraction quantile, 0 for an empty histogram.
+             */
+            std::chrono::nanoseconds percentile(double fraction) const noexcept;
+
+            std::array<std::uint64_t, bucketCount> buckets{};
+        };
+
+        struct WorkerMetrics
+        {
+            std::uint64_t tasksExecuted = 0;
+            std::uint64_t steals = 0;
+            std::chrono::nanoseconds busyTime{0};
+            std::chrono::nanoseconds idleTime{0};
+            bool active = false;
+
+            /**
+             * @return busyTime / (busyTime + idleTime), 0 before the worker did anything.
+             */
+            double utilization() const noexcept;
+        };
+
+        /**
+         * @brief Point in time copy of the pool counters. Counters are cumulative since construction.
+         */
+        struct Metrics
+        {
+            /**
+             * @brief One entry per worker slot, retired workers included.
+             */
+            std::vector<WorkerMetrics> workers;
+            /**
+             * @brief Tasks run by threads outside the pool while they wait().
+             */
+            WorkerMetrics external;
+            Histogram enqueueToStart;
+            Histogram runTime;
+            /**
+             * @brief Tasks waiting to start, indexed by Priority.
+             */
+            std::array<std::size_t, priorityCount> queueDepth{};
+            /**
+             * @brief Queued plus running tasks.
+             */
+            std::size_t pendingTasks = 0;
+        };
+
+        enum class Scheduling
+        {
+            /**
+             * @brief Every task goes through one mutex protected queue per Priority.
+             */
+            SharedQueue,
+            /**
+             * @brief One deque per worker. Tasks submitted from a worker stay on its deque,
+             * idle workers steal from random victims. External submissions go through the shared queue.
+             */
+            WorkStealing
+        };
+
+        enum class Affinity
+        {
+            /**
+             * @brief Workers are not pinned, the OS may migrate them. Every worker is in node 0.
+             */
+            None,
+            /**
+             * @brief Worker i is pinned to the i-th CPU, filling one NUMA node before the next.
+             */
+            Compact,
+            /**
+             * @brief Workers are pinned round robin over the NUMA nodes.
+             */
+            Spread
+        };
+
+        enum class ShutdownMode
+        {
+            /**
+             * @brief Runs every queued task, including the ones they submit, before the workers stop.
+             */
+            Drain,
+            /**
+             * @brief Running tasks finish, queued ones are destroyed without running.
+             * Their futures report std::future_errc::broken_promise.
+             */
+            Cancel
+        };
+
+        /**
+         * @brief What a worker does when it runs out of tasks, before it blocks in the kernel.
+         * Spinning trades CPU time of idle workers for wake-up latency of the next burst of tasks.
+         */
+        struct IdleStrategy
+        {
+            /**
+             * @brief pause instructions spent waiting for new work, roughly 10-40 ns each.
+             */
+            std::uint32_t spinCount = 4096;
+            /**
+             * @brief std::this_thread::yield() calls after spinning.
+             */
+            std::uint32_t yieldCount = 16;
+
+            /**
+             * @brief Blocks right away, the lowest CPU usage.
+             */
+            static constexpr IdleStrategy park() noexcept { return IdleStrategy{0, 0}; }
+        };
+
+        /**
+         * @param topology Only read during construction.
+         * @note Pinned workers are grouped by the node of their CPU. Idle workers steal inside their node first.
+         * Pinning is best effort, a CPU the process may not run on leaves its worker unpinned.
+         * resize() can grow the pool up to maxSize() = max(nThreads, 4 * hardware_concurrency()) workers.
+         */
+        ThreadPool(int nThreads, Scheduling scheduling = Scheduling::WorkStealing, Affinity affinity = Affinity::None,
+                   const Topology &topology = Topology::system());
+        /**
+         * @brief shutdown(ShutdownMode::Drain).
+         */
         ~ThreadPool();
 
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief Process wide pool with hardware_concurrency() workers.
+         * Created on first use and lives until program exit.
+         */
+        static ThreadPool &defaultPool();
+
+        /**
+         * @return Number of active workers, 0 after shutdown().
+         */
+        std::size_t size() const noexcept;
+
+        std::size_t maxSize() const noexcept;
+
+        Scheduling scheduling() const noexcept;
+
+        /**
+         * @brief Starts or retires workers, the pool keeps accepting tasks meanwhile.
+         * Retired workers finish their current task and the tasks on their own deque first, the call waits for that.
+         * @throws std::length_error if @p nThreads is above maxSize().
+         * @throws std::logic_error if called from a pool worker or after shutdown().
+         */
+        void resize(std::size_t nThreads);
+
+        /**
+         * @brief Blocks until no task is queued or running, executing queued tasks on the calling thread meanwhile.
+         * Once there is nothing to run it idles like a worker, see IdleStrategy, then sleeps until the pool drains.
+         * @throws std::logic_error if called from a pool worker, whose own task would never finish.
+         */
+        void waitIdle();
+
+        /**
+         * @brief Stops accepting tasks from outside the pool, then drains or cancels the queued ones and joins the workers.
+         * Later submissions throw std::runtime_error. Calling it again does nothing.
+         * @throws std::logic_error if called from a pool worker.
+         */
+        void shutdown(ShutdownMode mode = ShutdownMode::Drain);
+
+        /**
+         * @return Index of the calling worker or size() if called from a thread outside the pool.
+         */
+        std::size_t currentWorkerIndex() const noexcept;
+
+        /**
+         * @return Slot of the calling worker in [0, maxSize()), maxSize() if called from a thread outside the pool.
+         * Unlike currentWorkerIndex(), it never names another worker while resize() grows or shrinks the pool.
+         */
+        std::size_t currentSlot() const noexcept;
+
+        /**
+         * @return Number of NUMA nodes of the topology the workers are pinned to, 1 for Affinity::None.
+         * Tasks for a node without workers, e.g. after resize(), are run by any worker.
+         */
+        std::size_t nodeCount() const noexcept;
+
+        /**
+         * @return Node of worker @p workerIndex, in [0, nodeCount()). Nodes are numbered in Topology order.
+         */
+        std::size_t workerNode(std::size_t workerIndex) const noexcept;
+
+        /**
+         * @return CPU worker @p workerIndex is pinned to, nothing if it is not pinned.
+         */
+        std::optional<std::size_t> workerCpu(std::size_t workerIndex) const noexcept;
+
+        IdleStrategy idleStrategy() const noexcept;
+
+        /**
+         * @brief Picked up by every worker the next time it runs out of tasks.
+         */
+        void setIdleStrategy(IdleStrategy strategy) noexcept;
+
+        /**
+         * @note Reads relaxed counters while the workers keep updating them, so the numbers of
+         * one snapshot can be a few tasks apart from each other.
+         */
+        Metrics metrics() const;
+
+        /**
+         * @note The promise/future shared state comes from SmallObjectPool and the task is stored
+         * inline in a Task, so steady state submission does not touch the heap.
+         */
         template < class Fn, class... Args >
         std::future<std::invoke_result_t<Fn, Args...>> submit(Fn &&func, Args&&... args);
 
-        static void workFunction(Queue_t &tasks_);
+        template < class Fn, class... Args >
+        std::future<std::invoke_result_t<Fn, Args...>> submit(Priority priority, Fn &&func, Args&&... args);
+
+        /**
+         * @brief Fire and forget version of submit().
+         * @note An exception escaping @p func terminates the program, like for std::thread.
+         */
+        template < class Fn, class... Args >
+        void post(Fn &&func, Args&&... args);
+
+        template < class Fn, class... Args >
+        void post(Priority priority, Fn &&func, Args&&... args);
+
+        /**
+         * @brief Like submit(), but only workers of @p node run the task.
+         * @note Falls back to submit() for Scheduling::SharedQueue, where every worker serves the same queue.
+         */
+        template < class Fn, class... Args >
+        std::future<std::invoke_result_t<Fn, Args...>> submitToNode(std::size_t node, Fn &&func, Args&&... args);
+
+        /**
+         * @brief Runs one queued task on the calling thread, if there is any.
+         * Workers prefer their own deque, any thread may take from the shared queue or steal.
+         * @return True if a task was executed.
+         */
+        bool runPendingTask();
+
+        /**
+         * @brief Waits for @p future while executing queued tasks on the calling thread.
+         * Safe to call from inside a pool task: the worker keeps working instead of parking,
+         * so nested fork-join cannot starve the pool. Once there is nothing to run it idles like a worker,
+         * see IdleStrategy, then blocks on @p future, waking up every millisecond to look for new tasks.
+         * @return future.get()
+         */
+        template < class T >
+        T wait(std::future<T> &future);
 
     private:
-        Queue_t tasks_;
-        std::vector<std::jthread> work_threads_;
+        friend class TaskGroup;
+
+#ifdef S0_THREAD_POOL_METRICS
+        /**
+         * @brief Written by one worker only with plain relaxed load and store, the external
+         * counters are shared and use fetch_add.
+         */
+        struct Counters
+        {
+            void add(std::atomic<std::uint64_t> &counter, std::uint64_t value, bool shared) noexcept;
+            void record(std::array<std::atomic<std::uint64_t>, Histogram::bucketCount> &histogram, std::chrono::nanoseconds duration, bool shared) noexcept;
+            WorkerMetrics read() const noexcept;
+
+            std::atomic<std::uint64_t> tasksExecuted = 0;
+            std::atomic<std::uint64_t> steals = 0;
+            std::atomic<std::uint64_t> busyNanoseconds = 0;
+            std::atomic<std::uint64_t> idleNanoseconds = 0;
+            std::array<std::atomic<std::uint64_t>, Histogram::bucketCount> enqueueToStart{};
+            std::array<std::atomic<std::uint64_t>, Histogram::bucketCount> runTime{};
+        };
+
+        Counters &counters(std::size_t workerIndex) noexcept;
+#endif
+
+        struct alignas(64) Worker
+        {
+            ~Worker();
+
+            std::array<WorkStealingDeque<QueuedTask *>, priorityCount> deques;
+            std::size_t node = 0;
+            std::uint32_t picks = 0;
+            std::optional<std::size_t> cpu;
+            // A parked worker waits for wakeSignal to change, whoever clears sleeping owns the wake-up.
+            std::atomic_bool sleeping = false;
+            std::atomic<std::uint32_t> wakeSignal = 0;
+#ifdef S0_THREAD_POOL_METRICS
+            Counters counters;
+#endif
+            // Last member, so the thread is joined before the rest goes away.
+            std::jthread thread;
+        };
+
+        template < class Fn, class... Args >
+        static Task_t makeTask(std::promise<std::invoke_result_t<Fn, Args...>> promise, Fn &&func, Args&&... args);
+
+        void assignCpus(Affinity affinity, const Topology &topology);
+        void startWorkers(std::size_t nThreads);
+        void retireWorkers(std::size_t nThreads);
+        void acceptTask();
+        void execute(QueuedTask &task, Priority priority);
+        void execute(QueuedTask *node, Priority priority);
+        void push(Task_t task);
+        void push(Task_t task, std::size_t node);
+        void markQueued(std::size_t priority) noexcept;
+        bool levelEmpty(std::size_t priority) const;
+        bool runPendingTask(std::size_t workerIndex);
+        bool runPendingTask(std::size_t workerIndex, Priority priority);
+        bool pullFrom(Queue_t &queue, Priority priority);
+        void workFunction(std::size_t workerIndex);
+        void notifyWorker();
+        void notifyNode(std::size_t node);
+        bool wakeSleeper(std::size_t node, bool nodeOnly);
+        void wake(Worker &worker);
+        bool spinForWork(std::size_t workerIndex, std::uint64_t epoch) const noexcept;
+
+        /**
+         * @brief Runs queued tasks on the calling thread until ready(). Without a task to run it spins and yields
+         * like an idle worker, see IdleStrategy, then calls block(), which parks the thread until ready() may hold.
+         * block() returns after helpBlockTimeout at the latest, so the waiter keeps picking up tasks queued meanwhile.
+         */
+        template < class Ready, class Block >
+        void helpUntil(Ready &&ready, Block &&block);
+
+        /**
+         * @brief Spins or yields once for the @p round -th failed attempt to find a task in a row.
+         * @return false once the idle strategy is used up and the caller should block.
+         */
+        bool idleStep(std::uint64_t round) const noexcept;
+
+        /**
+         * @brief Blocks until ready() or helpBlockTimeout passes. Whoever makes ready() hold calls notifyIdle().
+         */
+        template < class Ready >
+        void blockUntil(Ready &&ready);
+
+        /**
+         * @brief Wakes the threads blocked in blockUntil().
+         */
+        void notifyIdle();
+        void park(std::size_t workerIndex, std::uint64_t epoch);
+        bool stealFrom(std::size_t workerIndex, Priority priority, bool sameNode);
+
+        Scheduling scheduling_;
+        // Every queue and deque exists once per Priority, indexed by its value.
+        std::array<Queue_t, priorityCount> tasks_;
+        std::vector<std::unique_ptr<std::array<Queue_t, priorityCount>>> nodeTasks_;
+        // Per priority: false only if no queue or deque held a task when checked, so empty levels are skipped
+        // without touching their queues. Set by markQueued(), cleared in runPendingTask().
+        std::array<std::atomic_bool, priorityCount> mayHaveTasks_ = {};
+        std::unique_ptr<std::atomic<std::size_t>[]> nodeWorkers_;
+        // (node, cpu) of every worker slot in pinning order, empty for Affinity::None.
+        std::vector<std::pair<std::size_t, std::size_t>> cpuSlots_;
+        // Slots are created on demand and never moved or destroyed before the pool, so thieves index them without locking.
+        // Slots [0, size_) have running workers, [size_, slotCount_) retired ones with empty deques.
+        std::size_t maxSize_;
+        std::unique_ptr<std::unique_ptr<Worker>[]> workers_;
+        std::atomic<std::size_t> slotCount_ = 0;
+        std::atomic<std::size_t> size_ = 0;
+        std::mutex resizeMutex_;
+        // Queued plus running tasks, for waitIdle() and shutdown().
+        std::atomic<std::size_t> pending_ = 0;
+        // Notified whenever pending_ or the count of a TaskGroup drops to zero.
+        std::mutex idleMutex_;
+        std::condition_variable idle_;
+        std::atomic_bool accepting_ = true;
+        std::atomic_bool cancelled_ = false;
+        std::atomic_bool stopped_ = false;
+        std::atomic<std::uint64_t> epoch_ = 0;
+        std::atomic<std::size_t> sleepers_ = 0;
+        std::atomic<std::uint32_t> spinCount_ = IdleStrategy().spinCount;
+        std::atomic<std::uint32_t> yieldCount_ = IdleStrategy().yieldCount;
+#ifdef S0_THREAD_POOL_METRICS
+        Counters externalCounters_;
+#endif
+
+        static constexpr std::chrono::milliseconds helpBlockTimeout{1};
     };
     
     template <class Fn, class... Args>
     inline std::future<std::invoke_result_t<Fn, Args...>> ThreadPool::submit(Fn &&func, Args &&...args)
     {
-        if constexpr (sizeof...(Args) > 0)
+        using Result_t = std::invoke_result_t<Fn, Args...>;
+        std::promise<Result_t> promise(std::allocator_arg, PoolAllocator<Result_t>());
+        auto future = promise.get_future();
+        push(makeTask(std::move(promise), std::forward<Fn>(func), std::forward<Args>(args)...));
+        return future;
+    }
+
+    template <class Fn, class... Args>
+    inline std::future<std::invoke_result_t<Fn, Args...>> ThreadPool::submit(Priority priority, Fn &&func, Args &&...args)
+    {
+        PriorityScope scope(priority);
+        return submit(std::forward<Fn>(func), std::forward<Args>(args)...);
+    }
+
+    template <class Fn, class... Args>
+    inline std::future<std::invoke_result_t<Fn, Args...>> ThreadPool::submitToNode(std::size_t node, Fn &&func, Args &&...args)
+    {
+        using Result_t = std::invoke_result_t<Fn, Args...>;
+        std::promise<Result_t> promise(std::allocator_arg, PoolAllocator<Result_t>());
+        auto future = promise.get_future();
+        push(makeTask(std::move(promise), std::forward<Fn>(func), std::forward<Args>(args)...), node);
+        return future;
+    }
+
+    template <class Fn, class... Args>
+    inline ThreadPool::Task_t ThreadPool::makeTask(std::promise<std::invoke_result_t<Fn, Args...>> promise, Fn &&func, Args &&...args)
+    {
+        using Result_t = std::invoke_result_t<Fn, Args...>;
+        return [promise=std::move(promise), func=std::forward<Fn>(func), ...args=std::forward<Args>(args)]() mutable
         {
-            using Result_t = std::invoke_result_t<Fn, Args...>;
-            auto task_ptr = std::make_shared<std::packaged_task<Result_t(Args...)>>(
-                [func=std::forward<Fn>(func), args=std::forward<Args...>(args...)]() mutable
+            try
+            {
+                if constexpr (std::is_void_v<Result_t>)
                 {
-                    return std::forward<Fn>(func)(std::forward<Args...>(args));
+                    std::invoke(std::move(func), std::move(args)...);
+                    promise.set_value();
                 }
-                );
-            auto future = task_ptr->get_future();
-            tasks_.wait_push([task_ptr=std::move(task_ptr)]() mutable {
-                (*task_ptr)();
-            });
-            return future;
+                else
+                {
+                    promise.set_value(std::invoke(std::move(func), std::move(args)...));
+                }
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        };
+    }
+
+    template <class Fn, class... Args>
+    inline void ThreadPool::post(Fn &&func, Args &&...args)
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            push(std::forward<Fn>(func));
         }
         else
         {
-            using Result_t = decltype(std::declval<Fn>()());
-            auto task_ptr = std::make_shared<std::packaged_task<Result_t()>>(
-                [func=std::forward<Fn>(func)]() mutable
+            push([func=std::forward<Fn>(func), ...args=std::forward<Args>(args)]() mutable
+            {
+                std::invoke(std::move(func), std::move(args)...);
+            });
+        }
+    }
+
+    template <class Fn, class... Args>
+    inline void ThreadPool::post(Priority priority, Fn &&func, Args &&...args)
+    {
+        PriorityScope scope(priority);
+        post(std::forward<Fn>(func), std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    inline T ThreadPool::wait(std::future<T> &future)
+    {
+        helpUntil([&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; },
+                  [&future]() { future.wait_for(helpBlockTimeout); });
+        return future.get();
+    }
+
+    template <class Ready, class Block>
+    inline void ThreadPool::helpUntil(Ready &&ready, Block &&block)
+    {
+        std::uint64_t idleRound = 0;
+        while (not ready())
+        {
+            if (runPendingTask())
+                idleRound = 0;
+            else if (idleStep(idleRound))
+                ++idleRound;
+            else
+                block();
+        }
+    }
+
+    template <class Ready>
+    inline void ThreadPool::blockUntil(Ready &&ready)
+    {
+        std::unique_lock lock(idleMutex_);
+        idle_.wait_for(lock, helpBlockTimeout, std::forward<Ready>(ready));
+    }
+
+    /**
+     * @brief Set of tasks that are joined together.
+     * wait() helps the pool before blocking, so groups can be nested from inside pool tasks.
+     */
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool &pool);
+
+        /**
+         * @brief Waits for the remaining tasks, dropping their exceptions.
+         */
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        template < class Fn >
+        void run(Fn &&func);
+
+        /**
+         * @brief Executes queued tasks until every task of the group has finished.
+         * Rethrows the first exception thrown by a task of the group.
+         */
+        void wait();
+
+    private:
+        /**
+         * @brief Finishes the task with broken_promise if ThreadPool::shutdown() cancels it before it runs.
+         */
+        struct Completion
+        {
+            explicit Completion(TaskGroup *group) noexcept : group(group) { }
+            Completion(Completion &&other) noexcept : group(std::exchange(other.group, nullptr)) { }
+            ~Completion();
+
+            TaskGroup *group;
+        };
+
+        void finish(std::exception_ptr exception);
+
+        ThreadPool &pool_;
+        std::atomic<std::size_t> pending_ = 0;
+        std::mutex exceptionMutex_;
+        std::exception_ptr exception_;
+    };
+
+    template <class Fn>
+    inline void TaskGroup::run(Fn &&func)
+    {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        try
+        {
+            pool_.push([this, func=std::forward<Fn>(func), completion=Completion(this)]() mutable {
+                std::exception_ptr exception;
+                try
                 {
-                    return std::forward<Fn>(func)();
+                    // Captures are released before finish() lets wait() return.
+                    auto localFunc = std::move(func);
+                    localFunc();
                 }
-                );
-            auto future = task_ptr->get_future();
-            tasks_.wait_push([task_ptr=std::move(task_ptr)]() mutable {
-                (*task_ptr)();
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+                completion.group = nullptr;
+                finish(std::move(exception));
             });
-            return future;
+        }
+        catch (...)
+        {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
         }
     }
 
@@ -0,0 +1,53 @@
+#ifndef S0_TOPOLOGY_HPP
+#define S0_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace s0m4b0dY
+{
+    struct NumaNode
+    {
+        std::size_t id = 0;
+        std::vector<std::size_t> cpus;
+    };
+
+    /**
+     * @brief NUMA nodes of the machine and the logical CPUs that belong to each of them.
+     */
+    class Topology
+    {
+    public:
+        /**
+         * @brief Nodes without CPUs are dropped. No nodes at all means a single node with hardware_concurrency() CPUs.
+         */
+        explicit Topology(std::vector<NumaNode> nodes);
+
+        /**
+         * @brief Topology of this machine, read once from /sys/devices/system/node on Linux.
+         * Everywhere else, or if sysfs is not readable, a single node.
+         */
+        static const Topology &system();
+
+        /**
+         * @brief Reads the node<N>/cpulist files of @p nodeDirectory.
+         */
+        static Topology fromSysfs(const std::filesystem::path &nodeDirectory);
+
+        /**
+         * @brief Parses the kernel cpu list format, e.g. "0-3,8,10-11".
+         * @throws std::invalid_argument if @p cpuList is malformed.
+         */
+        static std::vector<std::size_t> parseCpuList(std::string_view cpuList);
+
+        const std::vector<NumaNode> &nodes() const noexcept;
+        std::size_t cpuCount() const noexcept;
+
+    private:
+        std::vector<NumaNode> nodes_;
+    };
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef S0_WORK_STEALING_DEQUE_HPP
+#define S0_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <type_traits>
+
+namespace s0m4b0dY
+{
+    /**
+     * @brief Chase-Lev work stealing deque.
+     * The owner thread pushes and pops at the bottom without locking,
+     * any other thread steals from the top.
+     * @note T is copied through std::atomic, so it has to be trivially copyable (pointers, indices).
+     */
+    template < class T >
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque stores elements in std::atomic");
+    public:
+        explicit WorkStealingDeque(std::size_t capacity = 256);
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        /**
+         * @note Owner thread only.
+         */
+        void push(T value);
+
+        /**
+         * @note Owner thread only. LIFO end.
+         */
+        std::optional<T> pop();
+
+        /**
+         * @note Any thread. FIFO end.
+         */
+        std::optional<T> steal();
+
+        bool empty() const noexcept;
+
+        std::size_t size() const noexcept;
+
+    private:
+        struct Buffer
+        {
+            explicit Buffer(std::size_t capacity);
+
+            std::size_t capacity() const noexcept;
+            T get(std::int64_t index) const noexcept;
+            void put(std::int64_t index, T value) noexcept;
+
+            std::size_t mask;
+            std::unique_ptr<std::atomic<T>[]> slots;
+        };
+
+        Buffer *grow(Buffer *buffer, std::int64_t top, std::int64_t bottom);
+
+        alignas(64) std::atomic<std::int64_t> top_;
+        alignas(64) std::atomic<std::int64_t> bottom_;
+        std::atomic<Buffer *> buffer_;
+        // Thieves may still read from retired buffers, so they live as long as the deque.
+        std::vector<std::unique_ptr<Buffer>> buffers_;
+    };
+
+    template <class T>
+    inline WorkStealingDeque<T>::Buffer::Buffer(std::size_t capacity)
+        : mask(capacity - 1),
+          slots(std::make_unique<std::atomic<T>[]>(capacity))
+    { }
+
+    template <class T>
+    inline std::size_t WorkStealingDeque<T>::Buffer::capacity() const noexcept
+    {
+        return mask + 1;
+    }
+
+    template <class T>
+    inline T WorkStealingDeque<T>::Buffer::get(std::int64_t index) const noexcept
+    {
+        return slots[index & mask].load(std::memory_order_relaxed);
+    }
+
+    template <class T>
+    inline void WorkStealingDeque<T>::Buffer::put(std::int64_t index, T value) noexcept
+    {
+        slots[index & mask].store(value, std::memory_order_relaxed);
+    }
+
+    template <class T>
+    inline WorkStealingDeque<T>::WorkStealingDeque(std::size_t capacity)
+        : top_(0),
+          bottom_(0)
+    {
+        std::size_t powerOfTwo = 1;
+        while (powerOfTwo < capacity)
+            powerOfTwo <<= 1;
+        buffers_.push_back(std::make_unique<Buffer>(powerOfTwo));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    template <class T>
+    inline void WorkStealingDeque<T>::push(T value)
+    {
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_acquire);
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<std::int64_t>(buffer->capacity()) - 1)
+            buffer = grow(buffer, top, bottom);
+        buffer->put(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    template <class T>
+    inline std::optional<T> WorkStealingDeque<T>::pop()
+    {
+        auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = top_.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T value = buffer->get(bottom);
+        if (top == bottom)
+        {
+            // Last element, race against thieves for it.
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            if (not won)
+                return std::nullopt;
+        }
+        return value;
+    }
+
+    template <class T>
+    inline std::optional<T> WorkStealingDeque<T>::steal()
+    {
+        auto top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return std::nullopt;
+        Buffer *buffer = buffer_.load(std::memory_order_acquire);
+        T value = buffer->get(top);
+        if (not top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return std::nullopt;
+        return value;
+    }
+
+    template <class T>
+    inline bool WorkStealingDeque<T>::empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    template <class T>
+    inline std::size_t WorkStealingDeque<T>::size() const noexcept
+    {
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+    template <class T>
+    inline typename WorkStealingDeque<T>::Buffer *WorkStealingDeque<T>::grow(Buffer *buffer, std::int64_t top, std::int64_t bottom)
+    {
+        auto bigger = std::make_unique<Buffer>(buffer->capacity() * 2);
+        for (auto i = top; i < bottom; ++i)
+            bigger->put(i, buffer->get(i));
+        buffers_.push_back(std::move(bigger));
+        buffer_.store(buffers_.back().get(), std::memory_order_release);
+        return buffers_.back().get();
+    }
+}
+
+#endif
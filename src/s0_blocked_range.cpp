@@ -0,0 +1,98 @@
+#include "s0_blocked_range.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+namespace
+{
+    constexpr std::size_t maxDimensions = 3;
+
+    using Coordinates_t = std::array<std::uint64_t, maxDimensions>;
+
+    // Skilling, "Programming the Hilbert curve" (2004): turns axes into the transposed Hilbert index in place.
+    void axesToTranspose(Coordinates_t &x, unsigned bits, std::size_t dimensions)
+    {
+        std::uint64_t highest = std::uint64_t(1) << (bits - 1);
+        for (auto q = highest; q > 1; q >>= 1)
+        {
+            auto p = q - 1;
+            for (std::size_t i = 0; i < dimensions; ++i)
+            {
+                if (x[i] & q)
+                {
+                    x[0] ^= p;
+                }
+                else
+                {
+                    auto t = (x[0] ^ x[i]) & p;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                }
+            }
+        }
+        for (std::size_t i = 1; i < dimensions; ++i)
+            x[i] ^= x[i - 1];
+        std::uint64_t t = 0;
+        for (auto q = highest; q > 1; q >>= 1)
+        {
+            if (x[dimensions - 1] & q)
+                t ^= q - 1;
+        }
+        for (std::size_t i = 0; i < dimensions; ++i)
+            x[i] ^= t;
+    }
+
+    // Morton key of x, the first dimension takes the most significant bit of every group.
+    std::uint64_t interleave(const Coordinates_t &x, unsigned bits, std::size_t dimensions)
+    {
+        std::uint64_t key = 0;
+        for (auto bit = bits; bit-- > 0;)
+        {
+            for (std::size_t i = 0; i < dimensions; ++i)
+                key = (key << 1) | ((x[i] >> bit) & 1);
+        }
+        return key;
+    }
+}
+
+std::vector<std::size_t> s0m4b0dY::tileSequence(std::span<const std::size_t> tileCounts, TileOrder order)
+{
+    assert(tileCounts.size() <= maxDimensions && "At most 3 dimensions are supported");
+    std::size_t total = 1;
+    std::size_t longest = 1;
+    for (auto count : tileCounts)
+    {
+        total *= count;
+        longest = std::max(longest, count);
+    }
+    std::vector<std::size_t> sequence(total);
+    for (std::size_t i = 0; i < total; ++i)
+        sequence[i] = i;
+    if (order == TileOrder::RowMajor or total < 2)
+        return sequence;
+
+    unsigned bits = std::max(1, static_cast<int>(std::bit_width(longest - 1)));
+    auto dimensions = tileCounts.size();
+    std::vector<std::pair<std::uint64_t, std::size_t>> keys;
+    keys.reserve(total);
+    for (std::size_t i = 0; i < total; ++i)
+    {
+        Coordinates_t x{};
+        auto rest = i;
+        for (auto d = dimensions; d-- > 0;)
+        {
+            x[d] = rest % tileCounts[d];
+            rest /= tileCounts[d];
+        }
+        if (order == TileOrder::Hilbert)
+            axesToTranspose(x, bits, dimensions);
+        keys.emplace_back(interleave(x, bits, dimensions), i);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (std::size_t i = 0; i < total; ++i)
+        sequence[i] = keys[i].second;
+    return sequence;
+}
@@ -0,0 +1,99 @@
+#include "s0_partitioner.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    void splitEvenly(std::vector<std::pair<std::size_t, std::size_t>> &chunks, std::size_t size, std::size_t parts)
+    {
+        parts = std::clamp<std::size_t>(parts, 1, size);
+        chunks.reserve(parts);
+        for (std::size_t i = 0; i < parts; ++i)
+            chunks.emplace_back(size * i / parts, size * (i + 1) / parts);
+    }
+}
+
+s0m4b0dY::Partitioner::Partitioner() noexcept
+    : Partitioner(automatic())
+{ }
+
+s0m4b0dY::Partitioner::Partitioner(Kind kind, std::size_t grainSize, std::size_t sequentialThreshold, std::size_t chunksPerWorker) noexcept
+    : kind_(kind),
+      grainSize_(std::max<std::size_t>(grainSize, 1)),
+      sequentialThreshold_(sequentialThreshold),
+      chunksPerWorker_(std::max<std::size_t>(chunksPerWorker, 1))
+{ }
+
+s0m4b0dY::Partitioner s0m4b0dY::Partitioner::staticPartition() noexcept
+{
+    return Partitioner(Kind::Static, 1, 0, 1);
+}
+
+s0m4b0dY::Partitioner s0m4b0dY::Partitioner::fixedGrain(std::size_t grainSize) noexcept
+{
+    return Partitioner(Kind::FixedGrain, grainSize, 0, 1);
+}
+
+s0m4b0dY::Partitioner s0m4b0dY::Partitioner::guided(std::size_t minGrainSize) noexcept
+{
+    return Partitioner(Kind::Guided, minGrainSize, 0, 1);
+}
+
+s0m4b0dY::Partitioner s0m4b0dY::Partitioner::automatic(std::size_t sequentialThreshold, std::size_t chunksPerWorker, std::size_t minGrainSize) noexcept
+{
+    return Partitioner(Kind::Auto, minGrainSize, sequentialThreshold, chunksPerWorker);
+}
+
+s0m4b0dY::Partitioner::Kind s0m4b0dY::Partitioner::kind() const noexcept
+{
+    return kind_;
+}
+
+std::size_t s0m4b0dY::Partitioner::grainSize() const noexcept
+{
+    return grainSize_;
+}
+
+std::size_t s0m4b0dY::Partitioner::sequentialThreshold() const noexcept
+{
+    return sequentialThreshold_;
+}
+
+std::size_t s0m4b0dY::Partitioner::chunksPerWorker() const noexcept
+{
+    return chunksPerWorker_;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> s0m4b0dY::Partitioner::split(std::size_t size, std::size_t workers) const
+{
+    std::vector<std::pair<std::size_t, std::size_t>> chunks;
+    if (size == 0)
+        return chunks;
+    workers = std::max<std::size_t>(workers, 1);
+    switch (kind_)
+    {
+    case Kind::Static:
+        splitEvenly(chunks, size, workers);
+        break;
+    case Kind::FixedGrain:
+        chunks.reserve((size + grainSize_ - 1) / grainSize_);
+        for (std::size_t first = 0; first < size; first += grainSize_)
+            chunks.emplace_back(first, std::min(first + grainSize_, size));
+        break;
+    case Kind::Guided:
+        for (std::size_t first = 0; first < size;)
+        {
+            auto length = std::min(std::max((size - first) / workers, grainSize_), size - first);
+            chunks.emplace_back(first, first + length);
+            first += length;
+        }
+        break;
+    case Kind::Auto:
+        if (size < sequentialThreshold_ or workers == 1)
+            chunks.emplace_back(0, size);
+        else
+            splitEvenly(chunks, size, std::min(workers * chunksPerWorker_, (size + grainSize_ - 1) / grainSize_));
+        break;
+    }
+    return chunks;
+}
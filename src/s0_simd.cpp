@@ -0,0 +1,302 @@
+#include "s0_simd.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define S0_SIMD_X86 1
+#include <immintrin.h>
+#define S0_TARGET_AVX2 __attribute__((target("avx2")))
+#define S0_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace
+{
+    using s0m4b0dY::simd::Isa;
+
+    constexpr std::size_t pairwiseBlockSize = 1024;
+
+    // Integers are summed as unsigned, so overflow wraps instead of being undefined.
+    // Always inlined, so the AVX kernels do not call into non VEX code for their tails.
+    template < class T >
+    [[gnu::always_inline]] inline T scalarSum(const T *data, std::size_t size) noexcept
+    {
+        T accumulator0 = 0, accumulator1 = 0, accumulator2 = 0, accumulator3 = 0;
+        std::size_t unrolledSize = size - size % 4;
+        std::size_t i = 0;
+        for (; i < unrolledSize; i += 4)
+        {
+            accumulator0 += data[i];
+            accumulator1 += data[i + 1];
+            accumulator2 += data[i + 2];
+            accumulator3 += data[i + 3];
+        }
+        for (; i < size; ++i)
+            accumulator0 += data[i];
+        return (accumulator0 + accumulator1) + (accumulator2 + accumulator3);
+    }
+
+#ifdef S0_SIMD_X86
+    struct Avx2UInt32
+    {
+        using value_type = std::uint32_t;
+        using vector_type = __m256i;
+        static constexpr std::size_t lanes = 8;
+        S0_TARGET_AVX2 static vector_type zero() { return _mm256_setzero_si256(); }
+        S0_TARGET_AVX2 static vector_type load(const value_type *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+        S0_TARGET_AVX2 static vector_type add(vector_type lhs, vector_type rhs) { return _mm256_add_epi32(lhs, rhs); }
+        S0_TARGET_AVX2 static void store(value_type *data, vector_type value) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value); }
+    };
+
+    // Also instantiated for unsigned long long, which may be a distinct type from std::uint64_t.
+    template < class T >
+    struct Avx2UInt64Of
+    {
+        using value_type = T;
+        using vector_type = __m256i;
+        static constexpr std::size_t lanes = 4;
+        S0_TARGET_AVX2 static vector_type zero() { return _mm256_setzero_si256(); }
+        S0_TARGET_AVX2 static vector_type load(const value_type *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+        S0_TARGET_AVX2 static vector_type add(vector_type lhs, vector_type rhs) { return _mm256_add_epi64(lhs, rhs); }
+        S0_TARGET_AVX2 static void store(value_type *data, vector_type value) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value); }
+    };
+
+    struct Avx2Float
+    {
+        using value_type = float;
+        using vector_type = __m256;
+        static constexpr std::size_t lanes = 8;
+        S0_TARGET_AVX2 static vector_type zero() { return _mm256_setzero_ps(); }
+        S0_TARGET_AVX2 static vector_type load(const value_type *data) { return _mm256_loadu_ps(data); }
+        S0_TARGET_AVX2 static vector_type add(vector_type lhs, vector_type rhs) { return _mm256_add_ps(lhs, rhs); }
+        S0_TARGET_AVX2 static void store(value_type *data, vector_type value) { _mm256_storeu_ps(data, value); }
+    };
+
+    struct Avx2Double
+    {
+        using value_type = double;
+        using vector_type = __m256d;
+        static constexpr std::size_t lanes = 4;
+        S0_TARGET_AVX2 static vector_type zero() { return _mm256_setzero_pd(); }
+        S0_TARGET_AVX2 static vector_type load(const value_type *data) { return _mm256_loadu_pd(data); }
+        S0_TARGET_AVX2 static vector_type add(vector_type lhs, vector_type rhs) { return _mm256_add_pd(lhs, rhs); }
+        S0_TARGET_AVX2 static void store(value_type *data, vector_type value) { _mm256_storeu_pd(data, value); }
+    };
+
+    struct Avx512UInt32
+    {
+        using value_type = std::uint32_t;
+        using vector_type = __m512i;
+        static constexpr std::size_t lanes = 16;
+        S0_TARGET_AVX512 static vector_type zero() { return _mm512_setzero_si512(); }
+        S0_TARGET_AVX512 static vector_type load(const value_type *data) { return _mm512_loadu_si512(data); }
+        S0_TARGET_AVX512 static vector_type add(vector_type lhs, vector_type rhs) { return _mm512_add_epi32(lhs, rhs); }
+        S0_TARGET_AVX512 static void store(value_type *data, vector_type value) { _mm512_storeu_si512(data, value); }
+    };
+
+    template < class T >
+    struct Avx512UInt64Of
+    {
+        using value_type = T;
+        using vector_type = __m512i;
+        static constexpr std::size_t lanes = 8;
+        S0_TARGET_AVX512 static vector_type zero() { return _mm512_setzero_si512(); }
+        S0_TARGET_AVX512 static vector_type load(const value_type *data) { return _mm512_loadu_si512(data); }
+        S0_TARGET_AVX512 static vector_type add(vector_type lhs, vector_type rhs) { return _mm512_add_epi64(lhs, rhs); }
+        S0_TARGET_AVX512 static void store(value_type *data, vector_type value) { _mm512_storeu_si512(data, value); }
+    };
+
+    struct Avx512Float
+    {
+        using value_type = float;
+        using vector_type = __m512;
+        static constexpr std::size_t lanes = 16;
+        S0_TARGET_AVX512 static vector_type zero() { return _mm512_setzero_ps(); }
+        S0_TARGET_AVX512 static vector_type load(const value_type *data) { return _mm512_loadu_ps(data); }
+        S0_TARGET_AVX512 static vector_type add(vector_type lhs, vector_type rhs) { return _mm512_add_ps(lhs, rhs); }
+        S0_TARGET_AVX512 static void store(value_type *data, vector_type value) { _mm512_storeu_ps(data, value); }
+    };
+
+    struct Avx512Double
+    {
+        using value_type = double;
+        using vector_type = __m512d;
+        static constexpr std::size_t lanes = 8;
+        S0_TARGET_AVX512 static vector_type zero() { return _mm512_setzero_pd(); }
+        S0_TARGET_AVX512 static vector_type load(const value_type *data) { return _mm512_loadu_pd(data); }
+        S0_TARGET_AVX512 static vector_type add(vector_type lhs, vector_type rhs) { return _mm512_add_pd(lhs, rhs); }
+        S0_TARGET_AVX512 static void store(value_type *data, vector_type value) { _mm512_storeu_pd(data, value); }
+    };
+
+    using Avx2UInt64 = Avx2UInt64Of<std::uint64_t>;
+    using Avx512UInt64 = Avx512UInt64Of<std::uint64_t>;
+
+    // Four independent vector accumulators hide the add latency. The two kernels only differ in the target attribute.
+    template < class Ops >
+    S0_TARGET_AVX2 typename Ops::value_type avx2Sum(const typename Ops::value_type *data, std::size_t size) noexcept
+    {
+        constexpr auto step = 4 * Ops::lanes;
+        auto accumulator0 = Ops::zero(), accumulator1 = Ops::zero(), accumulator2 = Ops::zero(), accumulator3 = Ops::zero();
+        std::size_t i = 0;
+        for (; i + step <= size; i += step)
+        {
+            accumulator0 = Ops::add(accumulator0, Ops::load(data + i));
+            accumulator1 = Ops::add(accumulator1, Ops::load(data + i + Ops::lanes));
+            accumulator2 = Ops::add(accumulator2, Ops::load(data + i + 2 * Ops::lanes));
+            accumulator3 = Ops::add(accumulator3, Ops::load(data + i + 3 * Ops::lanes));
+        }
+        typename Ops::value_type lanes[Ops::lanes];
+        Ops::store(lanes, Ops::add(Ops::add(accumulator0, accumulator1), Ops::add(accumulator2, accumulator3)));
+        return scalarSum(lanes, Ops::lanes) + scalarSum(data + i, size - i);
+    }
+
+    template < class Ops >
+    S0_TARGET_AVX512 typename Ops::value_type avx512Sum(const typename Ops::value_type *data, std::size_t size) noexcept
+    {
+        constexpr auto step = 4 * Ops::lanes;
+        auto accumulator0 = Ops::zero(), accumulator1 = Ops::zero(), accumulator2 = Ops::zero(), accumulator3 = Ops::zero();
+        std::size_t i = 0;
+        for (; i + step <= size; i += step)
+        {
+            accumulator0 = Ops::add(accumulator0, Ops::load(data + i));
+            accumulator1 = Ops::add(accumulator1, Ops::load(data + i + Ops::lanes));
+            accumulator2 = Ops::add(accumulator2, Ops::load(data + i + 2 * Ops::lanes));
+            accumulator3 = Ops::add(accumulator3, Ops::load(data + i + 3 * Ops::lanes));
+        }
+        typename Ops::value_type lanes[Ops::lanes];
+        Ops::store(lanes, Ops::add(Ops::add(accumulator0, accumulator1), Ops::add(accumulator2, accumulator3)));
+        return scalarSum(lanes, Ops::lanes) + scalarSum(data + i, size - i);
+    }
+#endif
+
+    Isa detectIsa() noexcept
+    {
+#ifdef S0_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return Isa::Avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return Isa::Avx2;
+#endif
+        return Isa::Scalar;
+    }
+
+    std::atomic<Isa> &activeIsaStorage() noexcept
+    {
+        static std::atomic<Isa> isa = detectIsa();
+        return isa;
+    }
+
+    template < class Avx2Ops, class Avx512Ops >
+    typename Avx2Ops::value_type dispatchSum(const typename Avx2Ops::value_type *data, std::size_t size) noexcept
+    {
+#ifdef S0_SIMD_X86
+        switch (activeIsaStorage().load(std::memory_order_relaxed))
+        {
+        case Isa::Avx512:
+            return avx512Sum<Avx512Ops>(data, size);
+        case Isa::Avx2:
+            return avx2Sum<Avx2Ops>(data, size);
+        case Isa::Scalar:
+            break;
+        }
+#endif
+        return scalarSum(data, size);
+    }
+
+#ifndef S0_SIMD_X86
+    // Only value_type is used without x86 kernels.
+    template < class T >
+    struct ScalarOps
+    {
+        using value_type = T;
+    };
+    using Avx2UInt32 = ScalarOps<std::uint32_t>;
+    using Avx512UInt32 = ScalarOps<std::uint32_t>;
+    template < class T >
+    using Avx2UInt64Of = ScalarOps<T>;
+    template < class T >
+    using Avx512UInt64Of = ScalarOps<T>;
+    using Avx2UInt64 = ScalarOps<std::uint64_t>;
+    using Avx512UInt64 = ScalarOps<std::uint64_t>;
+    using Avx2Float = ScalarOps<float>;
+    using Avx512Float = ScalarOps<float>;
+    using Avx2Double = ScalarOps<double>;
+    using Avx512Double = ScalarOps<double>;
+#endif
+
+    template < class T >
+    T pairwiseSum(const T *data, std::size_t size) noexcept
+    {
+        if (size <= pairwiseBlockSize)
+            return s0m4b0dY::simd::sum(data, size);
+        auto half = (size / 2 + pairwiseBlockSize - 1) / pairwiseBlockSize * pairwiseBlockSize;
+        return pairwiseSum(data, half) + pairwiseSum(data + half, size - half);
+    }
+}
+
+s0m4b0dY::simd::Isa s0m4b0dY::simd::supportedIsa() noexcept
+{
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+s0m4b0dY::simd::Isa s0m4b0dY::simd::activeIsa() noexcept
+{
+    return activeIsaStorage().load(std::memory_order_relaxed);
+}
+
+void s0m4b0dY::simd::setActiveIsa(Isa isa) noexcept
+{
+    activeIsaStorage().store(isa < supportedIsa() ? isa : supportedIsa(), std::memory_order_relaxed);
+}
+
+std::int32_t s0m4b0dY::simd::sum(const std::int32_t *data, std::size_t size) noexcept
+{
+    return static_cast<std::int32_t>(sum(reinterpret_cast<const std::uint32_t *>(data), size));
+}
+
+std::uint32_t s0m4b0dY::simd::sum(const std::uint32_t *data, std::size_t size) noexcept
+{
+    return dispatchSum<Avx2UInt32, Avx512UInt32>(data, size);
+}
+
+std::int64_t s0m4b0dY::simd::sum(const std::int64_t *data, std::size_t size) noexcept
+{
+    return static_cast<std::int64_t>(sum(reinterpret_cast<const std::uint64_t *>(data), size));
+}
+
+std::uint64_t s0m4b0dY::simd::sum(const std::uint64_t *data, std::size_t size) noexcept
+{
+    return dispatchSum<Avx2UInt64, Avx512UInt64>(data, size);
+}
+
+template < class T >
+requires std::is_same_v<T, long long> or std::is_same_v<T, unsigned long long>
+T s0m4b0dY::simd::sum(const T *data, std::size_t size) noexcept
+{
+    using Unsigned_t = std::make_unsigned_t<T>;
+    return static_cast<T>(dispatchSum<Avx2UInt64Of<Unsigned_t>, Avx512UInt64Of<Unsigned_t>>(reinterpret_cast<const Unsigned_t *>(data), size));
+}
+
+template long long s0m4b0dY::simd::sum<long long>(const long long *data, std::size_t size) noexcept;
+template unsigned long long s0m4b0dY::simd::sum<unsigned long long>(const unsigned long long *data, std::size_t size) noexcept;
+
+float s0m4b0dY::simd::sum(const float *data, std::size_t size) noexcept
+{
+    return dispatchSum<Avx2Float, Avx512Float>(data, size);
+}
+
+double s0m4b0dY::simd::sum(const double *data, std::size_t size) noexcept
+{
+    return dispatchSum<Avx2Double, Avx512Double>(data, size);
+}
+
+float s0m4b0dY::simd::pairwise_sum(const float *data, std::size_t size) noexcept
+{
+    return pairwiseSum(data, size);
+}
+
+double s0m4b0dY::simd::pairwise_sum(const double *data, std::size_t size) noexcept
+{
+    return pairwiseSum(data, size);
+}
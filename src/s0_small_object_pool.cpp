@@ -0,0 +1,108 @@
+#include "s0_small_object_pool.hpp"
+
+#include <mutex>
+
+namespace
+{
+    using s0m4b0dY::SmallObjectPool;
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    constexpr std::size_t classCount = SmallObjectPool::maxSize / SmallObjectPool::granularity;
+    constexpr std::size_t cacheLimit = 64;
+    constexpr std::size_t batchSize = cacheLimit / 2;
+
+    struct GlobalFreeList
+    {
+        std::mutex mutex;
+        FreeBlock *head = nullptr;
+    };
+
+    GlobalFreeList globalFreeLists[classCount];
+
+    struct LocalCache
+    {
+        FreeBlock *heads[classCount] = {};
+        std::size_t counts[classCount] = {};
+
+        ~LocalCache()
+        {
+            for (std::size_t sizeClass = 0; sizeClass < classCount; sizeClass++)
+                flush(sizeClass, counts[sizeClass]);
+        }
+
+        // Moves @p n blocks of the class to the global list.
+        void flush(std::size_t sizeClass, std::size_t n)
+        {
+            if (n == 0)
+                return;
+            FreeBlock *first = heads[sizeClass];
+            FreeBlock *last = first;
+            for (std::size_t i = 1; i < n; i++)
+                last = last->next;
+            heads[sizeClass] = last->next;
+            counts[sizeClass] -= n;
+            std::lock_guard lock(globalFreeLists[sizeClass].mutex);
+            last->next = globalFreeLists[sizeClass].head;
+            globalFreeLists[sizeClass].head = first;
+        }
+
+        // Takes up to batchSize blocks of the class from the global list.
+        void refill(std::size_t sizeClass)
+        {
+            std::lock_guard lock(globalFreeLists[sizeClass].mutex);
+            auto &global = globalFreeLists[sizeClass];
+            while (global.head != nullptr and counts[sizeClass] < batchSize)
+            {
+                FreeBlock *block = global.head;
+                global.head = block->next;
+                block->next = heads[sizeClass];
+                heads[sizeClass] = block;
+                counts[sizeClass]++;
+            }
+        }
+    };
+
+    thread_local LocalCache localCache;
+
+    std::size_t sizeClassOf(std::size_t size)
+    {
+        return (size + SmallObjectPool::granularity - 1) / SmallObjectPool::granularity - 1;
+    }
+}
+
+void *s0m4b0dY::SmallObjectPool::allocate(std::size_t size)
+{
+    if (size == 0 or size > maxSize)
+        return ::operator new(size);
+    auto sizeClass = sizeClassOf(size);
+    if (localCache.heads[sizeClass] == nullptr)
+        localCache.refill(sizeClass);
+    if (FreeBlock *block = localCache.heads[sizeClass])
+    {
+        localCache.heads[sizeClass] = block->next;
+        localCache.counts[sizeClass]--;
+        return block;
+    }
+    return ::operator new((sizeClass + 1) * granularity);
+}
+
+void s0m4b0dY::SmallObjectPool::deallocate(void *pointer, std::size_t size) noexcept
+{
+    if (pointer == nullptr)
+        return;
+    if (size == 0 or size > maxSize)
+    {
+        ::operator delete(pointer);
+        return;
+    }
+    auto sizeClass = sizeClassOf(size);
+    auto *block = static_cast<FreeBlock *>(pointer);
+    block->next = localCache.heads[sizeClass];
+    localCache.heads[sizeClass] = block;
+    if (++localCache.counts[sizeClass] > cacheLimit)
+        localCache.flush(sizeClass, batchSize);
+}
@@ -1,28 +1,779 @@
 #include "s0_thread_pool.hpp"
 
-s0m4b0dY::ThreadPool::ThreadPool(int nThreads)
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace
 {
-    for (auto i = 0; i < nThreads; i++)
+    struct WorkerContext
+    {
+        const s0m4b0dY::ThreadPool *pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    thread_local WorkerContext currentWorker;
+
+    // Pool whose task the thread runs right now, workers or threads helping in wait().
+    thread_local const s0m4b0dY::ThreadPool *executingPool = nullptr;
+
+    thread_local s0m4b0dY::ThreadPool::Priority currentPriority = s0m4b0dY::ThreadPool::Priority::Normal;
+
+    constexpr std::size_t level(s0m4b0dY::ThreadPool::Priority priority) noexcept
     {
-        work_threads_.emplace_back(
-            workFunction, std::ref(tasks_)
-        );
+        return static_cast<std::size_t>(priority);
+    }
+
+    // Tasks on the worker deques are referenced by pointer, the nodes are recycled through SmallObjectPool.
+    template < class Node >
+    Node *makeTaskNode(Node &&task)
+    {
+        return ::new (s0m4b0dY::SmallObjectPool::allocate(sizeof(Node))) Node(std::move(task));
+    }
+
+    template < class Node >
+    void destroyTaskNode(Node *node) noexcept
+    {
+        node->~Node();
+        s0m4b0dY::SmallObjectPool::deallocate(node, sizeof(Node));
+    }
+
+    std::size_t nextRandom()
+    {
+        thread_local std::uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::size_t>(state);
+    }
+
+    // Tells the core we are spinning, so the sibling hyperthread gets the pipeline and the loop does not flood the memory bus.
+    inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    void pinCurrentThread(std::size_t cpu)
+    {
+#ifdef __linux__
+        if (cpu >= CPU_SETSIZE)
+            return;
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        // Best effort: a cpuset that excludes the CPU leaves the worker where it is.
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif
     }
 }
 
+s0m4b0dY::ThreadPool::ThreadPool(int nThreads, Scheduling scheduling, Affinity affinity, const Topology &topology)
+    : scheduling_(scheduling),
+      maxSize_(std::max<std::size_t>(std::max(nThreads, 0), 4 * std::thread::hardware_concurrency())),
+      workers_(std::make_unique<std::unique_ptr<Worker>[]>(maxSize_))
+{
+    assignCpus(affinity, topology);
+    startWorkers(std::max(nThreads, 0));
+}
+
 s0m4b0dY::ThreadPool::~ThreadPool()
 {
-    tasks_.close();
+    shutdown(ShutdownMode::Drain);
+}
+
+void s0m4b0dY::ThreadPool::assignCpus(Affinity affinity, const Topology &topology)
+{
+    const auto &nodes = topology.nodes();
+    if (affinity == Affinity::Compact)
+    {
+        for (std::size_t node = 0; node < nodes.size(); ++node)
+            for (auto cpu : nodes[node].cpus)
+                cpuSlots_.emplace_back(node, cpu);
+    }
+    else if (affinity == Affinity::Spread)
+    {
+        for (std::size_t round = 0; cpuSlots_.size() < topology.cpuCount(); ++round)
+            for (std::size_t node = 0; node < nodes.size(); ++node)
+                if (round < nodes[node].cpus.size())
+                    cpuSlots_.emplace_back(node, nodes[node].cpus[round]);
+    }
+    auto nodeCount = cpuSlots_.empty() ? 1 : nodes.size();
+    nodeTasks_.resize(nodeCount);
+    for (auto &queues : nodeTasks_)
+        queues = std::make_unique<std::array<Queue_t, priorityCount>>();
+    nodeWorkers_ = std::make_unique<std::atomic<std::size_t>[]>(nodeCount);
+}
+
+void s0m4b0dY::ThreadPool::startWorkers(std::size_t nThreads)
+{
+    auto first = size_.load(std::memory_order_relaxed);
+    for (auto i = slotCount_.load(std::memory_order_relaxed); i < nThreads; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        if (not cpuSlots_.empty())
+            std::tie(worker->node, worker->cpu) = cpuSlots_[i % cpuSlots_.size()];
+        workers_[i] = std::move(worker);
+        slotCount_.store(i + 1, std::memory_order_release);
+    }
+    // Published before the threads start, or they would retire right away.
+    size_.store(nThreads, std::memory_order_seq_cst);
+    for (auto i = first; i < nThreads; ++i)
+    {
+        nodeWorkers_[workers_[i]->node].fetch_add(1, std::memory_order_relaxed);
+        workers_[i]->thread = std::jthread(&ThreadPool::workFunction, this, i);
+    }
+}
+
+void s0m4b0dY::ThreadPool::retireWorkers(std::size_t nThreads)
+{
+    auto last = size_.load(std::memory_order_relaxed);
+    size_.store(nThreads, std::memory_order_seq_cst);
+    for (auto i = nThreads; i < last; ++i)
+    {
+        nodeWorkers_[workers_[i]->node].fetch_sub(1, std::memory_order_relaxed);
+        wake(*workers_[i]);
+    }
+    for (auto i = nThreads; i < last; ++i)
+        workers_[i]->thread.join();
+}
+
+s0m4b0dY::ThreadPool::Worker::~Worker()
+{
+    for (auto &deque : deques)
+        while (auto task = deque.pop())
+            destroyTaskNode(*task);
+}
+
+s0m4b0dY::ThreadPool::PriorityScope::PriorityScope(Priority priority) noexcept
+    : previous_(std::exchange(::currentPriority, priority))
+{ }
+
+s0m4b0dY::ThreadPool::PriorityScope::~PriorityScope()
+{
+    ::currentPriority = previous_;
+}
+
+s0m4b0dY::ThreadPool::Priority s0m4b0dY::ThreadPool::currentPriority() noexcept
+{
+    return ::currentPriority;
+}
+
+s0m4b0dY::ThreadPool &s0m4b0dY::ThreadPool::defaultPool()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+std::size_t s0m4b0dY::ThreadPool::size() const noexcept
+{
+    return size_.load(std::memory_order_relaxed);
+}
+
+std::size_t s0m4b0dY::ThreadPool::maxSize() const noexcept
+{
+    return maxSize_;
+}
+
+s0m4b0dY::ThreadPool::Scheduling s0m4b0dY::ThreadPool::scheduling() const noexcept
+{
+    return scheduling_;
+}
+
+void s0m4b0dY::ThreadPool::resize(std::size_t nThreads)
+{
+    if (nThreads > maxSize_)
+        throw std::length_error("ThreadPool::resize above maxSize()");
+    if (currentSlot() < maxSize_)
+        throw std::logic_error("ThreadPool::resize called from a pool worker");
+    std::lock_guard lock(resizeMutex_);
+    if (stopped_.load(std::memory_order_relaxed))
+        throw std::logic_error("ThreadPool::resize after shutdown");
+    if (nThreads > size_.load(std::memory_order_relaxed))
+        startWorkers(nThreads);
+    else
+        retireWorkers(nThreads);
+}
+
+void s0m4b0dY::ThreadPool::waitIdle()
+{
+    if (currentSlot() < maxSize_)
+        throw std::logic_error("ThreadPool::waitIdle called from a pool worker");
+    auto idle = [this]() { return pending_.load(std::memory_order_acquire) == 0; };
+    helpUntil(idle, [this, &idle]() { blockUntil(idle); });
+}
+
+void s0m4b0dY::ThreadPool::shutdown(ShutdownMode mode)
+{
+    if (currentSlot() < maxSize_)
+        throw std::logic_error("ThreadPool::shutdown called from a pool worker");
+    std::lock_guard lock(resizeMutex_);
+    if (stopped_.load(std::memory_order_relaxed))
+        return;
+    // Pairs with acceptTask(): a submitter either sees the flag or its task is counted in pending_.
+    accepting_.store(false, std::memory_order_seq_cst);
+    if (mode == ShutdownMode::Cancel)
+        cancelled_.store(true, std::memory_order_seq_cst);
+    // Workers still submit to each other meanwhile, the queues stay open until everything is done.
+    // Helping matters for a pool resized to zero workers.
+    auto idle = [this]() { return pending_.load(std::memory_order_seq_cst) == 0; };
+    helpUntil(idle, [this, &idle]() { blockUntil(idle); });
+    for (auto &queue : tasks_)
+        queue.close();
+    for (auto &queues : nodeTasks_)
+        for (auto &queue : *queues)
+            queue.close();
+    stopped_.store(true, std::memory_order_seq_cst);
+    retireWorkers(0);
+}
+
+std::size_t s0m4b0dY::ThreadPool::currentSlot() const noexcept
+{
+    return currentWorker.pool == this ? currentWorker.index : maxSize_;
+}
+
+std::size_t s0m4b0dY::ThreadPool::currentWorkerIndex() const noexcept
+{
+    return currentWorker.pool == this ? currentWorker.index : size();
+}
+
+std::size_t s0m4b0dY::ThreadPool::nodeCount() const noexcept
+{
+    return nodeTasks_.size();
+}
+
+s0m4b0dY::ThreadPool::IdleStrategy s0m4b0dY::ThreadPool::idleStrategy() const noexcept
+{
+    return IdleStrategy{spinCount_.load(std::memory_order_relaxed), yieldCount_.load(std::memory_order_relaxed)};
+}
+
+void s0m4b0dY::ThreadPool::setIdleStrategy(IdleStrategy strategy) noexcept
+{
+    spinCount_.store(strategy.spinCount, std::memory_order_relaxed);
+    yieldCount_.store(strategy.yieldCount, std::memory_order_relaxed);
+}
+
+s0m4b0dY::ThreadPool::Metrics s0m4b0dY::ThreadPool::metrics() const
+{
+    Metrics metrics;
+    for (std::size_t i = 0; i < priorityCount; ++i)
+    {
+        // Summed up here, so queueing a task costs nothing extra.
+        metrics.queueDepth[i] = tasks_[i].size();
+        for (const auto &queues : nodeTasks_)
+            metrics.queueDepth[i] += (*queues)[i].size();
+        auto slots = slotCount_.load(std::memory_order_acquire);
+        for (std::size_t slot = 0; slot < slots; ++slot)
+            metrics.queueDepth[i] += workers_[slot]->deques[i].size();
+    }
+    metrics.pendingTasks = pending_.load(std::memory_order_relaxed);
+#ifdef S0_THREAD_POOL_METRICS
+    auto accumulate = [](Histogram &histogram, const std::array<std::atomic<std::uint64_t>, Histogram::bucketCount> &buckets) {
+        for (std::size_t i = 0; i < Histogram::bucketCount; ++i)
+            histogram.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+    };
+    auto slots = slotCount_.load(std::memory_order_acquire);
+    auto size = size_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        const auto &counters = workers_[i]->counters;
+        metrics.workers.push_back(counters.read());
+        metrics.workers.back().active = i < size;
+        accumulate(metrics.enqueueToStart, counters.enqueueToStart);
+        accumulate(metrics.runTime, counters.runTime);
+    }
+    metrics.external = externalCounters_.read();
+    accumulate(metrics.enqueueToStart, externalCounters_.enqueueToStart);
+    accumulate(metrics.runTime, externalCounters_.runTime);
+#endif
+    return metrics;
+}
+
+std::uint64_t s0m4b0dY::ThreadPool::Histogram::count() const noexcept
+{
+    std::uint64_t total = 0;
+    for (auto bucket : buckets)
+        total += bucket;
+    return total;
+}
+
+std::chrono::nanoseconds s0m4b0dY::ThreadPool::Histogram::percentile(double fraction) const noexcept
+{
+    auto total = count();
+    if (total == 0)
+        return std::chrono::nanoseconds(0);
+    auto rank = static_cast<std::uint64_t>(std::clamp(fraction, 0.0, 1.0) * (total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::chrono::nanoseconds(std::int64_t(1) << i);
+    }
+    return std::chrono::nanoseconds(std::int64_t(1) << (bucketCount - 1));
+}
+
+double s0m4b0dY::ThreadPool::WorkerMetrics::utilization() const noexcept
+{
+    auto total = busyTime + idleTime;
+    return total.count() == 0 ? 0.0 : double(busyTime.count()) / double(total.count());
+}
+
+#ifdef S0_THREAD_POOL_METRICS
+void s0m4b0dY::ThreadPool::Counters::add(std::atomic<std::uint64_t> &counter, std::uint64_t value, bool shared) noexcept
+{
+    if (shared)
+        counter.fetch_add(value, std::memory_order_relaxed);
+    else
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void s0m4b0dY::ThreadPool::Counters::record(std::array<std::atomic<std::uint64_t>, Histogram::bucketCount> &histogram,
+                                            std::chrono::nanoseconds duration, bool shared) noexcept
+{
+    auto nanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+    auto bucket = std::min<std::size_t>(std::bit_width(nanoseconds), Histogram::bucketCount - 1);
+    add(histogram[bucket], 1, shared);
+}
+
+s0m4b0dY::ThreadPool::WorkerMetrics s0m4b0dY::ThreadPool::Counters::read() const noexcept
+{
+    WorkerMetrics metrics;
+    metrics.tasksExecuted = tasksExecuted.load(std::memory_order_relaxed);
+    metrics.steals = steals.load(std::memory_order_relaxed);
+    metrics.busyTime = std::chrono::nanoseconds(busyNanoseconds.load(std::memory_order_relaxed));
+    metrics.idleTime = std::chrono::nanoseconds(idleNanoseconds.load(std::memory_order_relaxed));
+    return metrics;
+}
+
+s0m4b0dY::ThreadPool::Counters &s0m4b0dY::ThreadPool::counters(std::size_t workerIndex) noexcept
+{
+    return workerIndex < maxSize_ ? workers_[workerIndex]->counters : externalCounters_;
 }
+#endif
 
-void s0m4b0dY::ThreadPool::workFunction(Queue_t &tasks_)
+std::size_t s0m4b0dY::ThreadPool::workerNode(std::size_t workerIndex) const noexcept
 {
+    return workerIndex < slotCount_.load(std::memory_order_acquire) ? workers_[workerIndex]->node : 0;
+}
+
+std::optional<std::size_t> s0m4b0dY::ThreadPool::workerCpu(std::size_t workerIndex) const noexcept
+{
+    return workerIndex < slotCount_.load(std::memory_order_acquire) ? workers_[workerIndex]->cpu : std::nullopt;
+}
+
+void s0m4b0dY::ThreadPool::acceptTask()
+{
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    // Tasks keep submitting while a drain runs, only outside threads are turned away.
+    if (not accepting_.load(std::memory_order_seq_cst) and executingPool != this)
+    {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        throw std::runtime_error("ThreadPool is shut down");
+    }
+}
+
+void s0m4b0dY::ThreadPool::execute(QueuedTask &task, Priority priority)
+{
+    struct Done
+    {
+        ~Done()
+        {
+            executingPool = previous;
+            if (pool.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pool.notifyIdle();
+        }
+        ThreadPool &pool;
+        const ThreadPool *previous;
+    } done{*this, std::exchange(executingPool, this)};
+    PriorityScope scope(priority);
+    if (cancelled_.load(std::memory_order_relaxed))
+        return;
+#ifdef S0_THREAD_POOL_METRICS
+    auto start = std::chrono::steady_clock::now();
+    task.task();
+    auto slot = currentSlot();
+    bool shared = slot >= maxSize_;
+    auto &counters = this->counters(slot);
+    counters.record(counters.enqueueToStart, start - task.enqueued, shared);
+    auto runTime = std::chrono::steady_clock::now() - start;
+    counters.record(counters.runTime, runTime, shared);
+    counters.add(counters.busyNanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(runTime).count(), shared);
+    counters.add(counters.tasksExecuted, 1, shared);
+#else
+    task.task();
+#endif
+}
+
+void s0m4b0dY::ThreadPool::execute(QueuedTask *node, Priority priority)
+{
+    std::unique_ptr<QueuedTask, decltype(&destroyTaskNode<QueuedTask>)> owner(node, &destroyTaskNode<QueuedTask>);
+    execute(*owner, priority);
+}
+
+void s0m4b0dY::ThreadPool::push(Task_t task)
+{
+    acceptTask();
+    auto workerIndex = currentSlot();
+    auto priority = level(::currentPriority);
+    try
+    {
+        if (scheduling_ == Scheduling::WorkStealing and workerIndex < maxSize_)
+            workers_[workerIndex]->deques[priority].push(makeTaskNode(QueuedTask{std::move(task)}));
+        else
+            tasks_[priority].wait_push(QueuedTask{std::move(task)});
+    }
+    catch (...)
+    {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+    markQueued(priority);
+    notifyWorker();
+}
+
+void s0m4b0dY::ThreadPool::push(Task_t task, std::size_t node)
+{
+    if (scheduling_ == Scheduling::SharedQueue)
+    {
+        push(std::move(task));
+        return;
+    }
+    acceptTask();
+    node %= nodeTasks_.size();
+    auto priority = level(::currentPriority);
+    try
+    {
+        (*nodeTasks_[node])[priority].wait_push(QueuedTask{std::move(task)});
+    }
+    catch (...)
+    {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+    markQueued(priority);
+    notifyNode(node);
+}
+
+void s0m4b0dY::ThreadPool::notifyWorker()
+{
+    // Spinning workers watch epoch_, parked ones have to be woken. A task pushed by a worker
+    // is best stolen by a neighbour on the same node.
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+        wakeSleeper(workerNode(currentSlot()), false);
+}
+
+void s0m4b0dY::ThreadPool::notifyNode(std::size_t node)
+{
+    // Only workers of the node run the task, unless it has none left.
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+        wakeSleeper(node, nodeWorkers_[node].load(std::memory_order_relaxed) > 0);
+}
+
+bool s0m4b0dY::ThreadPool::wakeSleeper(std::size_t node, bool nodeOnly)
+{
+    auto slots = slotCount_.load(std::memory_order_acquire);
+    auto start = nextRandom();
+    for (auto pass = 0; pass < (nodeOnly ? 1 : 2); ++pass)
+    {
+        for (std::size_t i = 0; i < slots; ++i)
+        {
+            auto &worker = *workers_[(start + i) % slots];
+            if (pass == 0 and worker.node != node)
+                continue;
+            bool sleeping = true;
+            if (worker.sleeping.load(std::memory_order_seq_cst)
+                and worker.sleeping.compare_exchange_strong(sleeping, false, std::memory_order_seq_cst))
+            {
+                worker.wakeSignal.fetch_add(1, std::memory_order_release);
+                worker.wakeSignal.notify_one();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void s0m4b0dY::ThreadPool::wake(Worker &worker)
+{
+    worker.sleeping.store(false, std::memory_order_seq_cst);
+    worker.wakeSignal.fetch_add(1, std::memory_order_release);
+    worker.wakeSignal.notify_one();
+}
+
+void s0m4b0dY::ThreadPool::markQueued(std::size_t priority) noexcept
+{
+    // Dekker style handshake with the clearing in runPendingTask(): either we see the hint cleared
+    // and set it again, or the clearing thread sees our task in levelEmpty(). The load keeps the
+    // cache line shared while the hint stays set.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (not mayHaveTasks_[priority].load(std::memory_order_relaxed))
+        mayHaveTasks_[priority].store(true, std::memory_order_relaxed);
+}
+
+bool s0m4b0dY::ThreadPool::levelEmpty(std::size_t priority) const
+{
+    if (not tasks_[priority].empty())
+        return false;
+    for (const auto &queues : nodeTasks_)
+    {
+        if (not (*queues)[priority].empty())
+            return false;
+    }
+    auto slots = slotCount_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        if (not workers_[i]->deques[priority].empty())
+            return false;
+    }
+    return true;
+}
+
+bool s0m4b0dY::ThreadPool::runPendingTask()
+{
+    return runPendingTask(currentSlot());
+}
+
+bool s0m4b0dY::ThreadPool::runPendingTask(std::size_t workerIndex)
+{
+    bool bottomUp = false;
+    if (workerIndex < maxSize_)
+        bottomUp = ++workers_[workerIndex]->picks % lowPriorityShare == 0;
+    for (std::size_t i = 0; i < priorityCount; ++i)
+    {
+        auto priority = static_cast<Priority>(bottomUp ? priorityCount - 1 - i : i);
+        auto &mayHaveTasks = mayHaveTasks_[level(priority)];
+        if (not mayHaveTasks.load(std::memory_order_relaxed))
+            continue;
+        if (runPendingTask(workerIndex, priority))
+            return true;
+        // Nothing we may take, which does not make the level empty: node queues are only served by their
+        // own workers. Clear the hint, then set it again if anything is still queued, see markQueued().
+        mayHaveTasks.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (not levelEmpty(level(priority)))
+            mayHaveTasks.store(true, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+bool s0m4b0dY::ThreadPool::runPendingTask(std::size_t workerIndex, Priority priority)
+{
+    auto index = level(priority);
+    bool isWorker = workerIndex < maxSize_;
+    if (isWorker)
+    {
+        if (auto task = workers_[workerIndex]->deques[index].pop())
+        {
+            execute(*task, priority);
+            return true;
+        }
+        if (pullFrom((*nodeTasks_[workers_[workerIndex]->node])[index], priority))
+            return true;
+    }
+    if (pullFrom(tasks_[index], priority))
+        return true;
+    // Queues of nodes that lost all their workers to resize() are served by everybody.
+    for (std::size_t node = 0; node < nodeTasks_.size(); ++node)
+    {
+        if (nodeWorkers_[node].load(std::memory_order_relaxed) == 0 and pullFrom((*nodeTasks_[node])[index], priority))
+            return true;
+    }
+    if (scheduling_ == Scheduling::SharedQueue)
+        return false;
+    if (isWorker and nodeTasks_.size() > 1 and stealFrom(workerIndex, priority, true))
+        return true;
+    return stealFrom(workerIndex, priority, false);
+}
+
+bool s0m4b0dY::ThreadPool::pullFrom(Queue_t &queue, Priority priority)
+{
+    QueuedTask task;
+    if (queue.try_pull(task) != boost::concurrent::queue_op_status::success)
+        return false;
+    execute(task, priority);
+    return true;
+}
+
+bool s0m4b0dY::ThreadPool::stealFrom(std::size_t workerIndex, Priority priority, bool sameNode)
+{
+    auto node = workerNode(workerIndex);
+    auto slots = slotCount_.load(std::memory_order_acquire);
+    auto victim = nextRandom();
+    for (std::size_t i = 0; i < slots; ++i, ++victim)
+    {
+        auto victimIndex = victim % slots;
+        if (victimIndex == workerIndex or (sameNode and workers_[victimIndex]->node != node))
+            continue;
+        if (auto stolen = workers_[victimIndex]->deques[level(priority)].steal())
+        {
+#ifdef S0_THREAD_POOL_METRICS
+            auto &counters = this->counters(workerIndex);
+            counters.add(counters.steals, 1, workerIndex >= maxSize_);
+#endif
+            execute(*stolen, priority);
+            return true;
+        }
+    }
+    return false;
+}
+
+void s0m4b0dY::ThreadPool::workFunction(std::size_t workerIndex)
+{
+    currentWorker = WorkerContext{this, workerIndex};
+    if (auto cpu = workers_[workerIndex]->cpu)
+        pinCurrentThread(*cpu);
+    auto &deques = workers_[workerIndex]->deques;
     while (true)
     {
-        Task_t task;
-        auto status = tasks_.wait_pull(task);
-        if (status == boost::concurrent::queue_op_status::closed)
-           return; 
-        task();
+        if (workerIndex >= size_.load(std::memory_order_seq_cst))
+        {
+            // Retired: nobody else pushes to our deques, leave them empty behind.
+            // A task may push to a more urgent deque than its own, so go over all of them until nothing is left.
+            bool drained = false;
+            while (not drained)
+            {
+                drained = true;
+                for (std::size_t i = 0; i < priorityCount; ++i)
+                {
+                    while (auto task = deques[i].pop())
+                    {
+                        execute(*task, static_cast<Priority>(i));
+                        drained = false;
+                    }
+                }
+            }
+            return;
+        }
+        auto epoch = epoch_.load(std::memory_order_seq_cst);
+        if (runPendingTask(workerIndex))
+            continue;
+#ifdef S0_THREAD_POOL_METRICS
+        auto idleStart = std::chrono::steady_clock::now();
+#endif
+        if (not spinForWork(workerIndex, epoch))
+            park(workerIndex, epoch);
+#ifdef S0_THREAD_POOL_METRICS
+        auto &counters = workers_[workerIndex]->counters;
+        counters.add(counters.idleNanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idleStart).count(), false);
+#endif
+    }
+}
+
+bool s0m4b0dY::ThreadPool::spinForWork(std::size_t workerIndex, std::uint64_t epoch) const noexcept
+{
+    auto changed = [this, workerIndex, epoch]() {
+        return epoch_.load(std::memory_order_relaxed) != epoch or workerIndex >= size_.load(std::memory_order_relaxed);
+    };
+    for (auto i = spinCount_.load(std::memory_order_relaxed); i > 0; --i)
+    {
+        if (changed())
+            return true;
+        cpuRelax();
+    }
+    for (auto i = yieldCount_.load(std::memory_order_relaxed); i > 0; --i)
+    {
+        if (changed())
+            return true;
+        std::this_thread::yield();
+    }
+    return changed();
+}
+
+bool s0m4b0dY::ThreadPool::idleStep(std::uint64_t round) const noexcept
+{
+    std::uint64_t spinCount = spinCount_.load(std::memory_order_relaxed);
+    if (round < spinCount)
+    {
+        cpuRelax();
+        return true;
+    }
+    if (round - spinCount < yieldCount_.load(std::memory_order_relaxed))
+    {
+        std::this_thread::yield();
+        return true;
+    }
+    return false;
+}
+
+void s0m4b0dY::ThreadPool::notifyIdle()
+{
+    // Taking the lock orders the notification after a blocked thread's check of its condition.
+    std::lock_guard lock(idleMutex_);
+    idle_.notify_all();
+}
+
+void s0m4b0dY::ThreadPool::park(std::size_t workerIndex, std::uint64_t epoch)
+{
+    // Dekker style handshake with notifyWorker() and retireWorkers():
+    // either we see the new epoch or size, or they see us sleeping.
+    auto &worker = *workers_[workerIndex];
+    auto signal = worker.wakeSignal.load(std::memory_order_acquire);
+    worker.sleeping.store(true, std::memory_order_seq_cst);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    if (epoch_.load(std::memory_order_seq_cst) == epoch and workerIndex < size_.load(std::memory_order_seq_cst))
+        worker.wakeSignal.wait(signal, std::memory_order_acquire);
+    worker.sleeping.store(false, std::memory_order_relaxed);
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+s0m4b0dY::TaskGroup::Completion::~Completion()
+{
+    if (group)
+        group->finish(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+}
+
+s0m4b0dY::TaskGroup::TaskGroup(ThreadPool &pool)
+    : pool_(pool)
+{ }
+
+s0m4b0dY::TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    { }
+}
+
+void s0m4b0dY::TaskGroup::wait()
+{
+    auto done = [this]() { return pending_.load(std::memory_order_acquire) == 0; };
+    pool_.helpUntil(done, [this, &done]() { pool_.blockUntil(done); });
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(exceptionMutex_);
+        exception = std::exchange(exception_, nullptr);
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void s0m4b0dY::TaskGroup::finish(std::exception_ptr exception)
+{
+    if (exception)
+    {
+        std::lock_guard lock(exceptionMutex_);
+        if (not exception_)
+            exception_ = std::move(exception);
     }
+    // The waiter may destroy the group as soon as the count reaches zero.
+    ThreadPool &pool = pool_;
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        pool.notifyIdle();
 }
@@ -0,0 +1,107 @@
+#include "s0_topology.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::size_t parseCpu(std::string_view text)
+    {
+        std::size_t cpu = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+        if (error != std::errc() or end != text.data() + text.size())
+            throw std::invalid_argument("Malformed cpu list entry: " + std::string(text));
+        return cpu;
+    }
+}
+
+s0m4b0dY::Topology::Topology(std::vector<NumaNode> nodes)
+    : nodes_(std::move(nodes))
+{
+    std::erase_if(nodes_, [](const NumaNode &node) { return node.cpus.empty(); });
+    std::sort(nodes_.begin(), nodes_.end(), [](const NumaNode &lhs, const NumaNode &rhs) { return lhs.id < rhs.id; });
+    if (nodes_.empty())
+    {
+        NumaNode node;
+        node.cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+        for (std::size_t cpu = 0; cpu < node.cpus.size(); ++cpu)
+            node.cpus[cpu] = cpu;
+        nodes_.push_back(std::move(node));
+    }
+}
+
+const s0m4b0dY::Topology &s0m4b0dY::Topology::system()
+{
+#ifdef __linux__
+    static const Topology topology = []() {
+        try
+        {
+            return fromSysfs("/sys/devices/system/node");
+        }
+        catch (...)
+        {
+            return Topology({});
+        }
+    }();
+#else
+    static const Topology topology({});
+#endif
+    return topology;
+}
+
+s0m4b0dY::Topology s0m4b0dY::Topology::fromSysfs(const std::filesystem::path &nodeDirectory)
+{
+    std::vector<NumaNode> nodes;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(nodeDirectory, error))
+    {
+        auto name = entry.path().filename().string();
+        if (not name.starts_with("node") or name.size() == 4
+            or not std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' and c <= '9'; }))
+            continue;
+        std::ifstream file(entry.path() / "cpulist");
+        std::string cpuList;
+        if (not std::getline(file, cpuList))
+            continue;
+        nodes.push_back(NumaNode{parseCpu(std::string_view(name).substr(4)), parseCpuList(cpuList)});
+    }
+    return Topology(std::move(nodes));
+}
+
+std::vector<std::size_t> s0m4b0dY::Topology::parseCpuList(std::string_view cpuList)
+{
+    std::vector<std::size_t> cpus;
+    while (not cpuList.empty() and (cpuList.back() == '\n' or cpuList.back() == ' '))
+        cpuList.remove_suffix(1);
+    while (not cpuList.empty())
+    {
+        auto comma = cpuList.find(',');
+        auto entry = cpuList.substr(0, comma);
+        cpuList = comma == std::string_view::npos ? std::string_view() : cpuList.substr(comma + 1);
+        auto dash = entry.find('-');
+        auto first = parseCpu(entry.substr(0, dash));
+        auto last = dash == std::string_view::npos ? first : parseCpu(entry.substr(dash + 1));
+        if (last < first)
+            throw std::invalid_argument("Malformed cpu list range: " + std::string(entry));
+        for (auto cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+const std::vector<s0m4b0dY::NumaNode> &s0m4b0dY::Topology::nodes() const noexcept
+{
+    return nodes_;
+}
+
+std::size_t s0m4b0dY::Topology::cpuCount() const noexcept
+{
+    std::size_t count = 0;
+    for (const auto &node : nodes_)
+        count += node.cpus.size();
+    return count;
+}